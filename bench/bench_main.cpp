@@ -0,0 +1,24 @@
+#include <benchmark/benchmark.h>
+#include <string_view>
+#include <vector>
+
+// Reports JSON on stdout unless another format is asked for, so results can be tracked across releases
+int main(int argc, char** argv) {
+    std::vector<char*> args(argv, argv + argc);
+    bool has_format = false;
+    for (std::string_view arg : args) {
+        has_format = has_format || arg.starts_with("--benchmark_format=");
+    }
+    char json_format[] = "--benchmark_format=json";
+    if (!has_format) {
+        args.push_back(json_format);
+    }
+    auto args_count = static_cast<int>(args.size());
+    benchmark::Initialize(&args_count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(args_count, args.data())) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include "bench_sources.hpp"
+
+namespace lox::bench {
+
+std::string MakeScript(size_t length) {
+    std::string script;
+    script.reserve(length + 128);
+    for (size_t i = 0; script.length() < length; ++i) {
+        auto n = std::to_string(i);
+        switch (i % 6) {
+            case 0:
+                script += "var v" + n + " = " + n + ".25 * (" + n + " == nil ? 2 : 3) - 1;\n";
+                break;
+            case 1:
+                script += "var s" + n + " = \"line " + n + "\" + \" of text\";  // trailing comment\n";
+                break;
+            case 2:
+                script += "{\n    var a = " + n + ";\n    var b = a / 2 + a * 3;\n    a = b - a;\n}\n";
+                break;
+            case 3:
+                script += "if (" + n + " > 10 and !false) { var c = 1; } else { var c = 2; }\n";
+                break;
+            case 4:
+                script += "/* block comment " + n + " */ for (var i = 0; i < 2; i = i + 1) { var d = i >= 1; }\n";
+                break;
+            default:
+                script += "var w" + n + " = true == (1 != 2) or nil;\n";
+                break;
+        }
+    }
+    return script;
+}
+
+std::string MakeCommentScript(size_t length) {
+    std::string script;
+    script.reserve(length + 128);
+    for (size_t i = 0; script.length() < length; ++i) {
+        auto n = std::to_string(i);
+        switch (i % 4) {
+            case 0:
+                script += "// Line comment " + n + " that explains the declaration below it in some detail.\n";
+                break;
+            case 1:
+                script += "/* Block comment " + n + "\n   spanning two lines of the script. */\n";
+                break;
+            case 2:
+                script += "    // Indented comment " + n + " after blank lines\n\n\n";
+                break;
+            default:
+                script += "var c" + n + " = " + n + ";  // trailing comment\n";
+                break;
+        }
+    }
+    return script;
+}
+
+std::string MakeStringScript(size_t length) {
+    std::string script;
+    script.reserve(length + 128);
+    for (size_t i = 0; script.length() < length; ++i) {
+        auto n = std::to_string(i);
+        if (i % 3 == 2) {
+            script += "var t" + n + " = \"A string literal " + n + " that goes on\nover a second line.\";\n";
+        } else {
+            script += "var s" + n + " = \"The quick brown fox " + n + " jumps over the lazy dog, twice.\" + \"!\";\n";
+        }
+    }
+    return script;
+}
+
+}  // namespace lox::bench
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace lox::bench {
+
+// Deterministic script of about `length` bytes mixing declarations, arithmetic, strings, comments,
+// blocks and control flow. It only defines globals it uses and never prints.
+std::string MakeScript(size_t length);
+// Mostly line and block comments, with a declaration every few lines
+std::string MakeCommentScript(size_t length);
+// Mostly long string literals, some of them spanning lines
+std::string MakeStringScript(size_t length);
+
+}  // namespace lox::bench
@@ -0,0 +1,125 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <data_structures/ast/value.hpp>
+#include <data_structures/environment/environment.hpp>
+#include <data_structures/tokens/symbols.hpp>
+#include <data_structures/tokens/tokens.hpp>
+#include <string>
+#include <vector>
+
+namespace lox::bench {
+
+namespace {
+
+// Token naming a variable, as the interpreter passes it for error messages
+tokens::Token MakeName(tokens::SymbolTable& symbols, const std::string& name) {
+    return {tokens::Type::kIdentifier, 0, static_cast<uint32_t>(name.length()), 1, symbols.Intern(name)};
+}
+
+// Globals, with as many of them defined as the argument
+std::vector<tokens::Token> MakeGlobals(tokens::SymbolTable& symbols, Environment& globals, int64_t count) {
+    std::vector<tokens::Token> names;
+    for (int64_t i = 0; i < count; ++i) {
+        names.push_back(MakeName(symbols, "global" + std::to_string(i)));
+        globals.Define(names.back().GetSymbol(), Value(static_cast<double>(i)));
+    }
+    return names;
+}
+
+void BM_EnvironmentDefine(benchmark::State& state) {
+    tokens::SymbolTable symbols;
+    Environment globals(symbols);
+    auto names = MakeGlobals(symbols, globals, state.range(0));
+    Value value(1.0);
+    size_t i = 0;
+    for (auto _ : state) {
+        globals.Define(names[i++ % names.size()].GetSymbol(), value);
+    }
+}
+BENCHMARK(BM_EnvironmentDefine)->Arg(16)->Arg(4096);
+
+void BM_EnvironmentGet(benchmark::State& state) {
+    tokens::SymbolTable symbols;
+    Environment globals(symbols);
+    auto names = MakeGlobals(symbols, globals, state.range(0));
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(&globals.Get(names[i++ % names.size()]));
+    }
+}
+BENCHMARK(BM_EnvironmentGet)->Arg(16)->Arg(4096);
+
+void BM_EnvironmentAssign(benchmark::State& state) {
+    tokens::SymbolTable symbols;
+    Environment globals(symbols);
+    auto names = MakeGlobals(symbols, globals, state.range(0));
+    Value value(1.0);
+    size_t i = 0;
+    for (auto _ : state) {
+        globals.Assign(names[i++ % names.size()], value);
+    }
+}
+BENCHMARK(BM_EnvironmentAssign)->Arg(16)->Arg(4096);
+
+// Blocks of 4 variables nested as deep as the argument, the variable read or written is in the outermost one
+constexpr uint32_t kSlotsPerBlock = 4;
+
+void PushBlocks(LocalScopes& locals, int64_t depth) {
+    for (int64_t i = 0; i < depth; ++i) {
+        locals.Push(kSlotsPerBlock);
+        for (uint32_t slot = 0; slot < kSlotsPerBlock; ++slot) {
+            locals.Define(slot, Value(static_cast<double>(slot)));
+        }
+    }
+}
+
+void BM_LocalsDefine(benchmark::State& state) {
+    tokens::SymbolTable symbols;
+    LocalScopes locals(symbols);
+    PushBlocks(locals, state.range(0));
+    Value value(1.0);
+    for (auto _ : state) {
+        locals.Define(1, value);
+    }
+}
+BENCHMARK(BM_LocalsDefine)->Arg(1)->Arg(4)->Arg(16)->Arg(64);
+
+void BM_LocalsGet(benchmark::State& state) {
+    tokens::SymbolTable symbols;
+    LocalScopes locals(symbols);
+    PushBlocks(locals, state.range(0));
+    auto name = MakeName(symbols, "local");
+    expressions::Slot slot{static_cast<uint32_t>(state.range(0) - 1), 1};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(&locals.Get(name, slot));
+    }
+}
+BENCHMARK(BM_LocalsGet)->Arg(1)->Arg(4)->Arg(16)->Arg(64);
+
+void BM_LocalsAssign(benchmark::State& state) {
+    tokens::SymbolTable symbols;
+    LocalScopes locals(symbols);
+    PushBlocks(locals, state.range(0));
+    expressions::Slot slot{static_cast<uint32_t>(state.range(0) - 1), 1};
+    Value value(1.0);
+    for (auto _ : state) {
+        locals.Assign(slot, value);
+    }
+}
+BENCHMARK(BM_LocalsAssign)->Arg(1)->Arg(4)->Arg(16)->Arg(64);
+
+// Entering and leaving a block, as every executed block statement does
+void BM_LocalsPushPop(benchmark::State& state) {
+    tokens::SymbolTable symbols;
+    LocalScopes locals(symbols);
+    PushBlocks(locals, state.range(0));
+    for (auto _ : state) {
+        ScopeGuard guard(&locals, kSlotsPerBlock);
+        benchmark::DoNotOptimize(&locals);
+    }
+}
+BENCHMARK(BM_LocalsPushPop)->Arg(1)->Arg(64);
+
+}  // namespace
+
+}  // namespace lox::bench
@@ -0,0 +1,122 @@
+#include <benchmark/benchmark.h>
+#include <data_structures/arena/arena.hpp>
+#include <data_structures/ast/ast_interpreter.hpp>
+#include <data_structures/ast/closure_interpreter.hpp>
+#include <data_structures/ast/resolver.hpp>
+#include <lox/lox.hpp>
+#include <parser/parser.hpp>
+#include <scanner/scanner.hpp>
+#include <string>
+#include <string_view>
+
+namespace lox::bench {
+
+namespace {
+
+// Kernels don't print, so the JSON report is the only output
+constexpr std::string_view kLoop = R"(
+var sum = 0;
+for (var i = 0; i < 100000; i = i + 1) {
+    sum = sum + i;
+}
+)";
+
+constexpr std::string_view kArithmetic = R"(
+{
+    var x = 1;
+    var y = 0;
+    for (var i = 0; i < 100000; i = i + 1) {
+        y = (x * 3 + i / 2 - 7) * 0.5 + (i > 50000 ? y : -y);
+        x = x + 1;
+    }
+}
+)";
+
+constexpr std::string_view kStrings = R"(
+{
+    var text = "";
+    for (var i = 0; i < 10000; i = i + 1) {
+        var part = "ab" + "cd";
+        if (part == "abcd") {
+            text = part + "!";
+        }
+    }
+}
+)";
+
+constexpr std::string_view kGlobals = R"(
+var a = 0;
+var b = 1;
+var i = 0;
+while (i < 100000) {
+    a = a + b;
+    b = a - b;
+    i = i + 1;
+}
+)";
+
+// `Interpreter` is AstInterpreter or ClosureInterpreter, so the two engines run the same kernels
+template <typename Interpreter>
+void BM_Interpret(benchmark::State& state, std::string_view source) {
+    Lox lox;
+    Arena arena;
+    Scanner scanner(source, lox);
+    Parser parser(scanner, source, arena, lox);
+    auto statements = parser.Parse();
+    Resolver resolver;
+    resolver.Resolve(statements);
+    Interpreter interpreter(lox);
+    for (auto _ : state) {
+        interpreter.Interpret(statements);
+    }
+}
+
+void BM_InterpretAst(benchmark::State& state, std::string_view source) {
+    BM_Interpret<AstInterpreter>(state, source);
+}
+BENCHMARK_CAPTURE(BM_InterpretAst, loop, kLoop)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_InterpretAst, arithmetic, kArithmetic)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_InterpretAst, strings, kStrings)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_InterpretAst, globals, kGlobals)->Unit(benchmark::kMillisecond);
+
+void BM_InterpretClosure(benchmark::State& state, std::string_view source) {
+    BM_Interpret<ClosureInterpreter>(state, source);
+}
+BENCHMARK_CAPTURE(BM_InterpretClosure, loop, kLoop)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_InterpretClosure, arithmetic, kArithmetic)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_InterpretClosure, strings, kStrings)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_InterpretClosure, globals, kGlobals)->Unit(benchmark::kMillisecond);
+
+// Builds two equal strings of `length` bytes by appending 64-byte pieces in a loop, then compares them so both are
+// read in full. Appending is expected to take linear time overall.
+void BM_Concatenate(benchmark::State& state) {
+    auto length = std::to_string(state.range(0));
+    auto source = "{\n"
+                  "    var piece = \"" + std::string(64, 'x') + "\";\n"
+                  "    var s = \"\";\n"
+                  "    var t = \"\";\n"
+                  "    for (var i = 0; i < " + length + " / 64; i = i + 1) {\n"
+                  "        s = s + piece;\n"
+                  "        t = t + piece;\n"
+                  "    }\n"
+                  "    var same = s == t;\n"
+                  "}\n";
+    Lox lox;
+    Arena arena;
+    Scanner scanner(source, lox);
+    Parser parser(scanner, source, arena, lox);
+    auto statements = parser.Parse();
+    Resolver resolver;
+    resolver.Resolve(statements);
+    AstInterpreter interpreter(lox);
+    for (auto _ : state) {
+        interpreter.Interpret(statements);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * 2 * state.range(0)));
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_Concatenate)->Range(1 << 10, 10 << 20)->Complexity(benchmark::oN)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+
+}  // namespace lox::bench
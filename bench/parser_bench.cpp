@@ -0,0 +1,107 @@
+#include <bench/bench_sources.hpp>
+#include <benchmark/benchmark.h>
+#include <data_structures/arena/arena.hpp>
+#include <lox/lox.hpp>
+#include <parser/parser.hpp>
+#include <scanner/scanner.hpp>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace lox::bench {
+
+namespace {
+
+// Counts the expression and statement nodes of a tree
+class NodeCounter {
+ public:
+    size_t Count(std::span<const statements::Stmt> statements) {
+        for (const auto& stmt : statements) {
+            Count(stmt);
+        }
+        return count_;
+    }
+
+    template <expressions::IsExpression Arg>
+    void operator()(const Arg& arg) {
+        ++count_;
+        if constexpr (std::is_same_v<Arg, expressions::Unary> || std::is_same_v<Arg, expressions::Grouping>) {
+            Count(*arg.expr_);
+        } else if constexpr (std::is_same_v<Arg, expressions::Binary> || std::is_same_v<Arg, expressions::Logical>) {
+            Count(*arg.left_);
+            Count(*arg.right_);
+        } else if constexpr (std::is_same_v<Arg, expressions::Conditional>) {
+            Count(*arg.first_);
+            Count(*arg.second_);
+            Count(*arg.third_);
+        } else if constexpr (std::is_same_v<Arg, expressions::Assign>) {
+            Count(*arg.value_);
+        }
+    }
+
+    template <statements::IsStatement Arg>
+    void operator()(const Arg& arg) {
+        ++count_;
+        if constexpr (std::is_same_v<Arg, statements::Expression> || std::is_same_v<Arg, statements::Print>) {
+            Count(*arg.expr_);
+        } else if constexpr (std::is_same_v<Arg, statements::Var>) {
+            if (arg.initializer_ != nullptr) {
+                Count(*arg.initializer_);
+            }
+        } else if constexpr (std::is_same_v<Arg, statements::Block>) {
+            Count(arg.statements_);
+        } else if constexpr (std::is_same_v<Arg, statements::If>) {
+            Count(*arg.condition_);
+            Count(*arg.then_branch_);
+            if (arg.else_branch_ != nullptr) {
+                Count(*arg.else_branch_);
+            }
+        } else if constexpr (std::is_same_v<Arg, statements::While>) {
+            Count(*arg.condition_);
+            Count(*arg.statement_);
+        }
+    }
+
+ private:
+    void Count(const expressions::Expr& expr) {
+        expr.Accept(*this);
+    }
+
+    void Count(const statements::Stmt& stmt) {
+        stmt.Accept(*this);
+    }
+
+ private:
+    size_t count_ = 0;
+};
+
+std::vector<statements::Stmt> Parse(std::string_view source, Arena& arena, Lox& lox) {
+    Scanner scanner(source, lox);
+    Parser parser(scanner, source, arena, lox);
+    return parser.Parse();
+}
+
+// Tokens are pulled from the scanner while parsing, so scanning is included
+void BM_Parse(benchmark::State& state) {
+    auto source = MakeScript(static_cast<size_t>(state.range(0)));
+    Lox lox;
+    size_t nodes_count = 0;
+    {
+        Arena arena;
+        nodes_count = NodeCounter().Count(Parse(source, arena, lox));
+    }
+    for (auto _ : state) {
+        Arena arena;
+        auto statements = Parse(source, arena, lox);
+        benchmark::DoNotOptimize(statements.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * source.length()));
+    state.counters["nodes"] =
+        benchmark::Counter(static_cast<double>(nodes_count * state.iterations()), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_Parse)->Arg(4 << 10)->Arg(256 << 10)->Arg(8 << 20)->Unit(benchmark::kMicrosecond);
+
+}  // namespace
+
+}  // namespace lox::bench
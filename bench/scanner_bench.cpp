@@ -0,0 +1,43 @@
+#include <bench/bench_sources.hpp>
+#include <benchmark/benchmark.h>
+#include <lox/lox.hpp>
+#include <scanner/scanner.hpp>
+#include <string>
+
+namespace lox::bench {
+
+namespace {
+
+void BM_ScanTokens(benchmark::State& state, std::string (*make_source)(size_t)) {
+    auto source = make_source(static_cast<size_t>(state.range(0)));
+    Lox lox;
+    size_t tokens_count = 0;
+    for (auto _ : state) {
+        Scanner scanner(source, lox);
+        auto tokens = scanner.ScanTokens();
+        tokens_count = tokens.size();
+        benchmark::DoNotOptimize(tokens.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * source.length()));
+    state.counters["tokens"] = benchmark::Counter(static_cast<double>(tokens_count * state.iterations()),
+                                                  benchmark::Counter::kIsRate);
+}
+BENCHMARK_CAPTURE(BM_ScanTokens, mixed, MakeScript)
+    ->Arg(4 << 10)
+    ->Arg(256 << 10)
+    ->Arg(8 << 20)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ScanTokens, comments, MakeCommentScript)
+    ->Arg(4 << 10)
+    ->Arg(256 << 10)
+    ->Arg(8 << 20)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ScanTokens, strings, MakeStringScript)
+    ->Arg(4 << 10)
+    ->Arg(256 << 10)
+    ->Arg(8 << 20)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace
+
+}  // namespace lox::bench
@@ -0,0 +1,53 @@
+#include <benchmark/benchmark.h>
+#include <data_structures/ast/value.hpp>
+#include <string>
+
+namespace lox::bench {
+
+namespace {
+
+Value MakeNumber() {
+    return Value(3.25);
+}
+
+Value MakeString() {
+    return Value(std::string("a string long enough to live on the heap"));
+}
+
+template <Value (*Make)()>
+void BM_ValueCopy(benchmark::State& state) {
+    auto value = Make();
+    for (auto _ : state) {
+        Value copy = value;
+        benchmark::DoNotOptimize(copy);
+    }
+}
+BENCHMARK(BM_ValueCopy<MakeNumber>)->Name("BM_ValueCopy/number");
+BENCHMARK(BM_ValueCopy<MakeString>)->Name("BM_ValueCopy/string");
+
+// Equal values made separately, so strings can't be told equal by their address
+template <Value (*Make)()>
+void BM_ValueCompare(benchmark::State& state) {
+    auto lhs = Make();
+    auto rhs = Make();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lhs == rhs);
+    }
+}
+BENCHMARK(BM_ValueCompare<MakeNumber>)->Name("BM_ValueCompare/number");
+BENCHMARK(BM_ValueCompare<MakeString>)->Name("BM_ValueCompare/string");
+
+template <Value (*Make)()>
+void BM_ValueStringify(benchmark::State& state) {
+    auto value = Make();
+    for (auto _ : state) {
+        auto text = value.Stringify();
+        benchmark::DoNotOptimize(text.data());
+    }
+}
+BENCHMARK(BM_ValueStringify<MakeNumber>)->Name("BM_ValueStringify/number");
+BENCHMARK(BM_ValueStringify<MakeString>)->Name("BM_ValueStringify/string");
+
+}  // namespace
+
+}  // namespace lox::bench
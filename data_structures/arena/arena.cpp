@@ -0,0 +1,54 @@
+#include "arena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+
+namespace lox {
+
+namespace {
+
+constexpr size_t kMinBlockSize = 4 * 1024;
+constexpr size_t kMaxBlockSize = 1024 * 1024;
+
+}  // namespace
+
+Arena::~Arena() {
+    for (auto it = destructors_.rbegin(); it != destructors_.rend(); ++it) {
+        it->destroy_(it->first_, it->count_);
+    }
+}
+
+void Arena::Adopt(Arena&& other) {
+    blocks_.insert(blocks_.end(), std::make_move_iterator(other.blocks_.begin()),
+                   std::make_move_iterator(other.blocks_.end()));
+    destructors_.insert(destructors_.end(), other.destructors_.begin(), other.destructors_.end());
+    other.blocks_.clear();
+    other.destructors_.clear();
+    other.current_ = nullptr;
+    other.remaining_ = 0;
+}
+
+size_t Arena::GetBlocksCount() const {
+    return blocks_.size();
+}
+
+void* Arena::Allocate(size_t size, size_t alignment) {
+    auto padding = -reinterpret_cast<uintptr_t>(current_) & (alignment - 1);
+    if (padding + size > remaining_) {
+        // Blocks grow geometrically, so a big program needs few of them and a REPL line stays cheap
+        next_block_size_ = std::clamp(next_block_size_ * 2, kMinBlockSize, kMaxBlockSize);
+        auto block_size = std::max(next_block_size_, size + alignment);
+        blocks_.push_back(std::make_unique_for_overwrite<std::byte[]>(block_size));
+        current_ = blocks_.back().get();
+        remaining_ = block_size;
+        padding = -reinterpret_cast<uintptr_t>(current_) & (alignment - 1);
+    }
+
+    auto* result = current_ + padding;
+    current_ += padding + size;
+    remaining_ -= padding + size;
+    return result;
+}
+
+}  // namespace lox
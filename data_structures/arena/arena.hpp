@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace lox {
+
+// Bump allocator owning the nodes of one parsed program. Everything is released at once
+// when the Arena is destroyed; only objects that are not trivially destructible pay for
+// a destructor call.
+class Arena {
+ public:
+    Arena() = default;
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    ~Arena();
+
+    template <typename T, typename... Args>
+    T* Make(Args&&... args) {
+        auto* object = new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            destructors_.push_back({object, 1, &Destroy<T>});
+        }
+        return object;
+    }
+
+    template <typename T>
+    std::span<T> MakeArray(std::vector<T>&& elements) {
+        if (elements.empty()) {
+            return {};
+        }
+        auto* first = static_cast<T*>(Allocate(sizeof(T) * elements.size(), alignof(T)));
+        std::uninitialized_move(elements.begin(), elements.end(), first);
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            destructors_.push_back({first, elements.size(), &Destroy<T>});
+        }
+        return {first, elements.size()};
+    }
+
+    // Takes over the objects and memory of `other`, which is left empty
+    void Adopt(Arena&& other);
+
+    // Number of memory blocks requested from the system so far
+    size_t GetBlocksCount() const;
+
+ private:
+    struct Destructor {
+        void* first_;
+        size_t count_;
+        void (*destroy_)(void*, size_t);
+    };
+
+ private:
+    void* Allocate(size_t size, size_t alignment);
+
+    template <typename T>
+    static void Destroy(void* first, size_t count) {
+        std::destroy_n(static_cast<T*>(first), count);
+    }
+
+ private:
+    std::vector<std::unique_ptr<std::byte[]>> blocks_;
+    std::byte* current_ = nullptr;
+    size_t remaining_ = 0;
+    size_t next_block_size_ = 0;
+    std::vector<Destructor> destructors_;
+};
+
+}  // namespace lox
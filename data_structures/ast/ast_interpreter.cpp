@@ -1,15 +1,28 @@
 #include "ast_interpreter.hpp"
 
 #include <cassert>
+#include <jit/loop_jit.hpp>
 #include <lox/errors.hpp>
 #include <lox/lox.hpp>
 
 namespace lox {
 
-AstInterpreter::AstInterpreter(lox::Lox& lox) : lox_(lox) {
+template <typename Profiler>
+BasicAstInterpreter<Profiler>::BasicAstInterpreter(lox::Lox& lox, bool jit)
+    : globals_(lox.GetSymbols()), locals_(lox.GetSymbols()), output_(lox.GetOutput()), lox_(lox) {
+    if (jit) {
+        jit_ = std::make_unique<jit::LoopJit>(globals_, locals_, output_);
+    }
 }
 
-void AstInterpreter::Interpret(const std::vector<statements::Stmt>& statements) {
+template <typename Profiler>
+BasicAstInterpreter<Profiler>::~BasicAstInterpreter() = default;
+
+template <typename Profiler>
+void BasicAstInterpreter<Profiler>::Interpret(const std::vector<statements::Stmt>& statements) {
+    if (jit_ != nullptr) {
+        jit_->Clear();
+    }
     try {
         for (const auto& statement : statements) {
             Execute(statement);
@@ -19,23 +32,36 @@ void AstInterpreter::Interpret(const std::vector<statements::Stmt>& statements)
     }
 }
 
-void AstInterpreter::Execute(const statements::Stmt& stmt) {
-    return stmt.Accept(*this);
+template <typename Profiler>
+void BasicAstInterpreter<Profiler>::Execute(const statements::Stmt& stmt) {
+    if constexpr (Profiler::kEnabled) {
+        typename Profiler::Scope scope(profiler_, stmt);
+        stmt.Accept(*this);
+    } else {
+        stmt.Accept(*this);
+    }
 }
 
-void AstInterpreter::ExecuteBlock(const statements::Block& block) {
-    EnvironmentGuard guard(&environment_);
-    environment_ = Environment(guard.GetSaved());
+template <typename Profiler>
+void BasicAstInterpreter<Profiler>::ExecuteBlock(const statements::Block& block) {
+    ScopeGuard guard(&locals_, block.slots_count_);
     for (const auto& statement : block.statements_) {
         Execute(statement);
     }
 }
 
-Value AstInterpreter::Evaluate(const expressions::Expr& expr) {
+template <typename Profiler>
+bool BasicAstInterpreter<Profiler>::RunCompiled(const statements::While& loop) {
+    return jit_ != nullptr && jit_->Run(loop);
+}
+
+template <typename Profiler>
+Value BasicAstInterpreter<Profiler>::Evaluate(const expressions::Expr& expr) {
     return expr.Accept(*this);
 }
 
-Value AstInterpreter::EvaluateUnary(const expressions::Unary& expr) {
+template <typename Profiler>
+Value BasicAstInterpreter<Profiler>::EvaluateUnary(const expressions::Unary& expr) {
     Value rhs = Evaluate(*expr.expr_);
     if (expr.op_.GetType() == tokens::Type::kMinus) {
         CheckNumberOperand(expr.op_, rhs);
@@ -46,9 +72,127 @@ Value AstInterpreter::EvaluateUnary(const expressions::Unary& expr) {
     return rhs;
 }
 
-Value AstInterpreter::EvaluateBinary(const expressions::Binary& expr) {
+template <typename Profiler>
+Value BasicAstInterpreter<Profiler>::EvaluateBinary(const expressions::Binary& expr) {
+    using expressions::Specialization;
+
     Value lhs = Evaluate(*expr.left_);
     Value rhs = Evaluate(*expr.right_);
+    bool numbers = lhs.Is<double>() && rhs.Is<double>();
+    switch (expr.specialization_) {
+        case Specialization::kNumberAdd:
+            if (numbers) {
+                return Value(lhs.As<double>() + rhs.As<double>());
+            }
+            break;
+        case Specialization::kNumberSubtract:
+            if (numbers) {
+                return Value(lhs.As<double>() - rhs.As<double>());
+            }
+            break;
+        case Specialization::kNumberMultiply:
+            if (numbers) {
+                return Value(lhs.As<double>() * rhs.As<double>());
+            }
+            break;
+        case Specialization::kNumberDivide:
+            // Division by zero is reported by the generic path
+            if (numbers && rhs.As<double>() != 0) {
+                return Value(lhs.As<double>() / rhs.As<double>());
+            }
+            break;
+        case Specialization::kNumberGreater:
+            if (numbers) {
+                return Value(lhs.As<double>() > rhs.As<double>());
+            }
+            break;
+        case Specialization::kNumberGreaterEqual:
+            if (numbers) {
+                return Value(lhs.As<double>() >= rhs.As<double>());
+            }
+            break;
+        case Specialization::kNumberLess:
+            if (numbers) {
+                return Value(lhs.As<double>() < rhs.As<double>());
+            }
+            break;
+        case Specialization::kNumberLessEqual:
+            if (numbers) {
+                return Value(lhs.As<double>() <= rhs.As<double>());
+            }
+            break;
+        case Specialization::kStringConcat:
+            if (lhs.Is<std::string>() && rhs.Is<std::string>()) {
+                return Value::Concatenate(lhs, rhs);
+            }
+            break;
+        case Specialization::kEqual:
+            return Value(lhs == rhs);
+        case Specialization::kNotEqual:
+            return Value(lhs != rhs);
+        case Specialization::kNone:
+        case Specialization::kGeneric:
+            break;
+    }
+    return EvaluateGenericBinary(expr, lhs, rhs);
+}
+
+template <typename Profiler>
+Value BasicAstInterpreter<Profiler>::EvaluateGenericBinary(const expressions::Binary& expr, const Value& lhs,
+                                                           const Value& rhs) {
+    using expressions::Specialization;
+
+    // Throws before specializing if the operands are wrong for the operator
+    auto result = EvaluateOperator(expr, lhs, rhs);
+    if (expr.specialization_ == Specialization::kNone) {
+        expr.specialization_ = Specialize(expr.op_.GetType(), lhs, rhs);
+    } else if (expr.specialization_ != Specialization::kGeneric) {
+        // The guard failed: the node has seen more than one combination of types
+        expr.specialization_ = Specialization::kGeneric;
+    }
+    return result;
+}
+
+template <typename Profiler>
+expressions::Specialization BasicAstInterpreter<Profiler>::Specialize(tokens::Type type, const Value& lhs,
+                                                                      const Value& rhs) {
+    using expressions::Specialization;
+
+    if (type == tokens::Type::kEqualEqual) {
+        return Specialization::kEqual;
+    } else if (type == tokens::Type::kBangEqual) {
+        return Specialization::kNotEqual;
+    } else if (type == tokens::Type::kPlus && lhs.Is<std::string>()) {
+        return Specialization::kStringConcat;
+    } else if (!lhs.Is<double>() || !rhs.Is<double>()) {
+        return Specialization::kGeneric;
+    }
+
+    switch (type) {
+        case tokens::Type::kPlus:
+            return Specialization::kNumberAdd;
+        case tokens::Type::kMinus:
+            return Specialization::kNumberSubtract;
+        case tokens::Type::kStar:
+            return Specialization::kNumberMultiply;
+        case tokens::Type::kSlash:
+            return Specialization::kNumberDivide;
+        case tokens::Type::kGreater:
+            return Specialization::kNumberGreater;
+        case tokens::Type::kGreaterEqual:
+            return Specialization::kNumberGreaterEqual;
+        case tokens::Type::kLess:
+            return Specialization::kNumberLess;
+        case tokens::Type::kLessEqual:
+            return Specialization::kNumberLessEqual;
+        default:
+            return Specialization::kGeneric;
+    }
+}
+
+template <typename Profiler>
+Value BasicAstInterpreter<Profiler>::EvaluateOperator(const expressions::Binary& expr, const Value& lhs,
+                                                      const Value& rhs) {
     if (expr.op_.GetType() == tokens::Type::kPlus) {
         return SumOrConcatenate(expr.op_, lhs, rhs);
     } else if (tokens::IsArithmetic(expr.op_.GetType()) || tokens::IsComparison(expr.op_.GetType())) {
@@ -58,6 +202,9 @@ Value AstInterpreter::EvaluateBinary(const expressions::Binary& expr) {
         return Value(lhs != rhs);
     } else if (expr.op_.GetType() == tokens::Type::kEqualEqual) {
         return Value(lhs == rhs);
+    } else if (expr.op_.GetType() == tokens::Type::kComma) {
+        // Both operands have been evaluated, the comma yields the right one
+        return rhs;
     } else {
         // Unreachable
         assert(false && "Unknown operation");
@@ -65,7 +212,8 @@ Value AstInterpreter::EvaluateBinary(const expressions::Binary& expr) {
     }
 }
 
-Value AstInterpreter::EvaluateConditional(const expressions::Conditional& expr) {
+template <typename Profiler>
+Value BasicAstInterpreter<Profiler>::EvaluateConditional(const expressions::Conditional& expr) {
     auto condition = Evaluate(*expr.first_);
     if (IsTruthy(condition)) {
         return Evaluate(*expr.second_);
@@ -74,7 +222,8 @@ Value AstInterpreter::EvaluateConditional(const expressions::Conditional& expr)
     }
 }
 
-Value AstInterpreter::NumberOperation(const tokens::Token& op, double lhs, double rhs) const {
+template <typename Profiler>
+Value BasicAstInterpreter<Profiler>::NumberOperation(const tokens::Token& op, double lhs, double rhs) const {
     auto type = op.GetType();
     if (type == tokens::Type::kMinus) {
         return Value(lhs - rhs);
@@ -100,9 +249,11 @@ Value AstInterpreter::NumberOperation(const tokens::Token& op, double lhs, doubl
     }
 }
 
-Value AstInterpreter::SumOrConcatenate(const tokens::Token& op, const lox::Value& lhs, const lox::Value& rhs) const {
+template <typename Profiler>
+Value BasicAstInterpreter<Profiler>::SumOrConcatenate(const tokens::Token& op, const lox::Value& lhs,
+                                                      const lox::Value& rhs) const {
     if (lhs.Is<std::string>() && rhs.Is<std::string>()) {
-        return Value(lhs.As<std::string>() + rhs.As<std::string>());
+        return Value::Concatenate(lhs, rhs);
     } else if (lhs.Is<double>() && rhs.Is<double>()) {
         return Value(lhs.As<double>() + rhs.As<double>());
     } else {
@@ -110,7 +261,8 @@ Value AstInterpreter::SumOrConcatenate(const tokens::Token& op, const lox::Value
     }
 }
 
-bool AstInterpreter::IsTruthy(const lox::Value& value) const {
+template <typename Profiler>
+bool BasicAstInterpreter<Profiler>::IsTruthy(const lox::Value& value) const {
     static constexpr auto kVisitor = [](const auto& arg) -> bool {
         using T = std::decay_t<decltype(arg)>;
         if constexpr (std::is_same_v<T, std::monostate>) {
@@ -125,16 +277,22 @@ bool AstInterpreter::IsTruthy(const lox::Value& value) const {
     return value.Accept(kVisitor);
 }
 
-void AstInterpreter::CheckNumberOperand(const tokens::Token& op, const lox::Value& value) const {
+template <typename Profiler>
+void BasicAstInterpreter<Profiler>::CheckNumberOperand(const tokens::Token& op, const lox::Value& value) const {
     if (!value.Is<double>()) {
         throw RuntimeError(op, "Operand must be a number.");
     }
 }
 
-void AstInterpreter::CheckNumberOperands(const tokens::Token& op, const lox::Value& lhs, const lox::Value& rhs) const {
+template <typename Profiler>
+void BasicAstInterpreter<Profiler>::CheckNumberOperands(const tokens::Token& op, const lox::Value& lhs,
+                                                        const lox::Value& rhs) const {
     if (!lhs.Is<double>() || !rhs.Is<double>()) {
         throw RuntimeError(op, "Operands must be numbers.");
     }
 }
 
+template class BasicAstInterpreter<NoProfiler>;
+template class BasicAstInterpreter<LineProfiler>;
+
 }  // namespace lox
@@ -1,24 +1,42 @@
 #pragma once
 
 #include <data_structures/ast/expressions.hpp>
+#include <data_structures/ast/line_profiler.hpp>
 #include <data_structures/ast/statements.hpp>
 #include <data_structures/ast/value.hpp>
 #include <data_structures/environment/environment.hpp>
-#include <iostream>
+#include <lox/output_sink.hpp>
+#include <memory>
 #include <vector>
 
 namespace lox {
 
 class Lox;
 
-class AstInterpreter {
+namespace jit {
+
+class LoopJit;
+
+}  // namespace jit
+
+// `Profiler` is NoProfiler or LineProfiler, which times every executed statement
+template <typename Profiler>
+class BasicAstInterpreter {
  public:
-    explicit AstInterpreter(Lox& lox);
+    // With `jit`, loops that only compute with numbers run as machine code
+    explicit BasicAstInterpreter(Lox& lox, bool jit = false);
+    ~BasicAstInterpreter();
     void Interpret(const std::vector<statements::Stmt>& statements);
 
+    const Profiler& GetProfiler() const {
+        return profiler_;
+    }
+
     template <expressions::IsExpression Arg>
     Value operator()(const Arg& arg) {
-        if constexpr (expressions::IsLiteral<Arg>) {
+        if constexpr (std::is_same_v<Arg, expressions::String>) {
+            return *arg.constant_;
+        } else if constexpr (expressions::IsLiteral<Arg>) {
             return Value(arg.value_);
         } else if constexpr (std::is_same_v<Arg, expressions::Unary>) {
             return EvaluateUnary(arg);
@@ -29,10 +47,17 @@ class AstInterpreter {
         } else if constexpr (std::is_same_v<Arg, expressions::Grouping>) {
             return Evaluate(*arg.expr_);
         } else if constexpr (std::is_same_v<Arg, expressions::Variable>) {
-            return environment_.Get(arg.name_);
+            if (arg.slot_.has_value()) {
+                return locals_.Get(arg.name_, *arg.slot_);
+            }
+            return globals_.Get(arg.name_);
         } else if constexpr (std::is_same_v<Arg, expressions::Assign>) {
             auto value = Evaluate(*arg.value_);
-            environment_.Assign(arg.name_, value);
+            if (arg.slot_.has_value()) {
+                locals_.Assign(*arg.slot_, value);
+            } else {
+                globals_.Assign(arg.name_, value);
+            }
             return value;
         } else if constexpr (std::is_same_v<Arg, expressions::Logical>) {
             Value lhs = Evaluate(*arg.left_);
@@ -53,7 +78,8 @@ class AstInterpreter {
     void operator()(const Arg& arg) {
         if constexpr (std::is_same_v<Arg, statements::Print>) {
             auto value = Evaluate(*arg.expr_);
-            std::cout << value.Stringify() << "\n";
+            value.Print(output_);
+            output_.EndLine();
         } else if constexpr (std::is_same_v<Arg, statements::Expression>) {
             Evaluate(*arg.expr_);
         } else if constexpr (std::is_same_v<Arg, statements::Var>) {
@@ -61,7 +87,11 @@ class AstInterpreter {
             if (arg.initializer_ != nullptr) {
                 value = Evaluate(*arg.initializer_);
             }
-            environment_.Define(arg.name_.GetLexeme(), value);
+            if (arg.slot_.has_value()) {
+                locals_.Define(*arg.slot_, value);
+            } else {
+                globals_.Define(arg.name_.GetSymbol(), value);
+            }
         } else if constexpr (std::is_same_v<Arg, statements::Block>) {
             ExecuteBlock(arg);
         } else if constexpr (std::is_same_v<Arg, statements::If>) {
@@ -71,6 +101,9 @@ class AstInterpreter {
                 Execute(*arg.else_branch_);
             }
         } else if constexpr (std::is_same_v<Arg, statements::While>) {
+            if (RunCompiled(arg)) {
+                return;
+            }
             while (IsTruthy(Evaluate(*arg.condition_))) {
                 Execute(*arg.statement_);
             }
@@ -82,9 +115,14 @@ class AstInterpreter {
  private:
     void Execute(const statements::Stmt& stmt);
     void ExecuteBlock(const statements::Block& block);
+    // Returns false if the loop has to be interpreted
+    bool RunCompiled(const statements::While& loop);
     Value Evaluate(const expressions::Expr& expr);
     Value EvaluateUnary(const expressions::Unary& expr);
     Value EvaluateBinary(const expressions::Binary& expr);
+    Value EvaluateGenericBinary(const expressions::Binary& expr, const Value& lhs, const Value& rhs);
+    Value EvaluateOperator(const expressions::Binary& expr, const Value& lhs, const Value& rhs);
+    static expressions::Specialization Specialize(tokens::Type type, const Value& lhs, const Value& rhs);
     Value EvaluateConditional(const expressions::Conditional& expr);
     Value NumberOperation(const tokens::Token& op, double lhs, double rhs) const;
     Value SumOrConcatenate(const tokens::Token& op, const Value& lhs, const Value& rhs) const;
@@ -93,8 +131,19 @@ class AstInterpreter {
     void CheckNumberOperands(const tokens::Token& op, const lox::Value& lhs, const lox::Value& rhs) const;
 
  private:
-    Environment environment_;
+    Environment globals_;
+    LocalScopes locals_;
+    OutputSink& output_;
     Lox& lox_;
+    // nullptr unless the JIT is enabled
+    std::unique_ptr<jit::LoopJit> jit_;
+    [[no_unique_address]] Profiler profiler_;
 };
 
+extern template class BasicAstInterpreter<NoProfiler>;
+extern template class BasicAstInterpreter<LineProfiler>;
+
+using AstInterpreter = BasicAstInterpreter<NoProfiler>;
+using ProfilingAstInterpreter = BasicAstInterpreter<LineProfiler>;
+
 }  // namespace lox
@@ -1,11 +1,33 @@
 #include "ast_printer.hpp"
 
-#include <iostream>
+#include <array>
+#include <lox/numbers.hpp>
 
 namespace lox {
 
+AstPrinter::AstPrinter(const tokens::SymbolTable& symbols) : symbols_(symbols) {
+}
+
 std::string AstPrinter::Print(const expressions::Expr& expr) const {
     return expr.Accept(*this);
 }
 
+std::string AstPrinter::Print(const statements::Stmt& stmt) const {
+    return stmt.Accept(*this);
+}
+
+std::string AstPrinter::Print(std::span<const statements::Stmt> statements) const {
+    std::string result;
+    for (const auto& statement : statements) {
+        result += Print(statement);
+        result += "\n";
+    }
+    return result;
+}
+
+std::string AstPrinter::PrintNumber(double value) {
+    std::array<char, kMaxNumberLength> buffer;
+    return std::string(FormatNumber(value, buffer));
+}
+
 }  // namespace lox
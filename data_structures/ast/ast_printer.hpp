@@ -1,37 +1,82 @@
 #pragma once
 
 #include <data_structures/ast/expressions.hpp>
+#include <data_structures/ast/statements.hpp>
+#include <data_structures/tokens/symbols.hpp>
+#include <span>
+#include <string>
 
 namespace lox {
 
+// Prints the tree as s-expressions, one top-level statement per line
 class AstPrinter {
  public:
+    // Variable names are looked up in `symbols`
+    explicit AstPrinter(const tokens::SymbolTable& symbols);
     std::string Print(const expressions::Expr& expr) const;
+    std::string Print(const statements::Stmt& stmt) const;
+    std::string Print(std::span<const statements::Stmt> statements) const;
 
-    template <typename Arg>
+    template <expressions::IsExpression Arg>
     std::string operator()(const Arg& arg) const {
         if constexpr (std::is_same_v<Arg, expressions::String>) {
-            return arg.value_;
+            return std::string(arg.value_);
         } else if constexpr (std::is_same_v<Arg, expressions::Number>) {
-            return std::to_string(arg.value_);
+            return PrintNumber(arg.value_);
         } else if constexpr (std::is_same_v<Arg, expressions::Boolean>) {
             return arg.value_ ? "true" : "false";
         } else if constexpr (std::is_same_v<Arg, expressions::Nil>) {
             return "nil";
         } else if constexpr (std::is_same_v<Arg, expressions::Unary>) {
-            return Parenthesize(arg.op_.GetLexeme(), *arg.expr_);
+            return Parenthesize(tokens::AsString(arg.op_.GetType()), *arg.expr_);
         } else if constexpr (std::is_same_v<Arg, expressions::Binary>) {
-            return Parenthesize(arg.op_.GetLexeme(), *arg.left_, *arg.right_);
+            return Parenthesize(tokens::AsString(arg.op_.GetType()), *arg.left_, *arg.right_);
         } else if constexpr (std::is_same_v<Arg, expressions::Conditional>) {
             return Parenthesize("?", *arg.first_, *arg.second_, *arg.third_);
         } else if constexpr (std::is_same_v<Arg, expressions::Grouping>) {
             return Parenthesize("group", *arg.expr_);
+        } else if constexpr (std::is_same_v<Arg, expressions::Variable>) {
+            return symbols_.GetName(arg.name_.GetSymbol());
+        } else if constexpr (std::is_same_v<Arg, expressions::Assign>) {
+            return Parenthesize("= " + symbols_.GetName(arg.name_.GetSymbol()), *arg.value_);
+        } else if constexpr (std::is_same_v<Arg, expressions::Logical>) {
+            auto name = arg.op_.GetType() == tokens::Type::kOr ? "or" : "and";
+            return Parenthesize(name, *arg.left_, *arg.right_);
         } else {
             throw std::runtime_error("Unexpected expression type.");
         }
     }
 
+    template <statements::IsStatement Arg>
+    std::string operator()(const Arg& arg) const {
+        if constexpr (std::is_same_v<Arg, statements::Print>) {
+            return Parenthesize("print", *arg.expr_);
+        } else if constexpr (std::is_same_v<Arg, statements::Expression>) {
+            return Parenthesize(";", *arg.expr_);
+        } else if constexpr (std::is_same_v<Arg, statements::Var>) {
+            auto name = "var " + symbols_.GetName(arg.name_.GetSymbol());
+            return arg.initializer_ != nullptr ? Parenthesize(name, *arg.initializer_) : "(" + name + ")";
+        } else if constexpr (std::is_same_v<Arg, statements::Block>) {
+            std::string result = "(block";
+            for (const auto& statement : arg.statements_) {
+                result += ParenthesizeImpl(statement);
+            }
+            return result + ")";
+        } else if constexpr (std::is_same_v<Arg, statements::If>) {
+            if (arg.else_branch_ != nullptr) {
+                return Parenthesize("if", *arg.condition_, *arg.then_branch_, *arg.else_branch_);
+            }
+            return Parenthesize("if", *arg.condition_, *arg.then_branch_);
+        } else if constexpr (std::is_same_v<Arg, statements::While>) {
+            return Parenthesize("while", *arg.condition_, *arg.statement_);
+        } else {
+            throw std::runtime_error("Unexpected statement type.");
+        }
+    }
+
  private:
+    static std::string PrintNumber(double value);
+
     template <typename T>
     std::string ParenthesizeImpl(const T& t) const {
         return " " + t.Accept(*this);
@@ -49,6 +94,9 @@ class AstPrinter {
         result += ")";
         return result;
     }
+
+ private:
+    const tokens::SymbolTable& symbols_;
 };
 
 }  // namespace lox
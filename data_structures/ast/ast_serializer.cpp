@@ -0,0 +1,464 @@
+#include "ast_serializer.hpp"
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace lox {
+
+namespace {
+
+enum class ExprTag : uint8_t {
+    kString,
+    kNumber,
+    // A number that is a small non-negative integer
+    kInteger,
+    kBoolean,
+    kNil,
+    kUnary,
+    kBinary,
+    kConditional,
+    kGrouping,
+    kVariable,
+    kAssign,
+    kLogical,
+};
+
+enum class StmtTag : uint8_t {
+    kExpression,
+    kPrint,
+    kVar,
+    kBlock,
+    kIf,
+    kWhile,
+};
+
+// Integers up to 2^53 convert to and from double exactly
+constexpr uint64_t kMaxInteger = uint64_t{1} << 53;
+
+bool IsInteger(double value) {
+    return value >= 0 && value <= static_cast<double>(kMaxInteger) && value == std::floor(value) &&
+           !std::signbit(value);
+}
+
+bool HasName(tokens::Type type) {
+    return type == tokens::Type::kIdentifier || type == tokens::Type::kString;
+}
+
+// Whether the parser can make a node with the tag out of a token of the type, the interpreters rely on it
+bool IsValidToken(ExprTag tag, tokens::Type type) {
+    switch (tag) {
+        case ExprTag::kUnary:
+            return type == tokens::Type::kMinus || type == tokens::Type::kBang;
+        case ExprTag::kBinary:
+            return tokens::IsArithmetic(type) || tokens::IsComparison(type) || type == tokens::Type::kEqualEqual ||
+                   type == tokens::Type::kBangEqual || type == tokens::Type::kComma;
+        case ExprTag::kLogical:
+            return type == tokens::Type::kAnd || type == tokens::Type::kOr;
+        default:
+            return type == tokens::Type::kIdentifier;
+    }
+}
+
+// The encoding is a list of names followed by the statements in preorder, every node starts with its tag.
+// Integers are LEB128. Token positions, and lines of tokens and statements, are zigzag-encoded differences from the
+// previous ones.
+class AstWriter {
+ public:
+    explicit AstWriter(const tokens::SymbolTable& symbols) : symbols_(symbols) {
+    }
+
+    std::string Write(std::span<const statements::Stmt> statements) {
+        WriteUint(statements.size());
+        for (const auto& statement : statements) {
+            Write(statement);
+        }
+
+        std::string tree = std::move(data_);
+        data_.clear();
+        WriteUint(names_.size());
+        for (auto name : names_) {
+            WriteUint(name.size());
+            data_ += name;
+        }
+        return data_ + tree;
+    }
+
+    template <expressions::IsExpression Arg>
+    void operator()(const Arg& arg) {
+        if constexpr (std::is_same_v<Arg, expressions::String>) {
+            WriteTag(ExprTag::kString);
+            WriteName(arg.value_);
+        } else if constexpr (std::is_same_v<Arg, expressions::Number>) {
+            if (IsInteger(arg.value_)) {
+                WriteTag(ExprTag::kInteger);
+                WriteUint(static_cast<uint64_t>(arg.value_));
+                return;
+            }
+            WriteTag(ExprTag::kNumber);
+            auto bits = std::bit_cast<uint64_t>(arg.value_);
+            for (int i = 0; i < 8; ++i) {
+                data_ += static_cast<char>(bits >> (8 * i));
+            }
+        } else if constexpr (std::is_same_v<Arg, expressions::Boolean>) {
+            WriteTag(ExprTag::kBoolean);
+            data_ += static_cast<char>(arg.value_);
+        } else if constexpr (std::is_same_v<Arg, expressions::Nil>) {
+            WriteTag(ExprTag::kNil);
+        } else if constexpr (std::is_same_v<Arg, expressions::Unary>) {
+            WriteTag(ExprTag::kUnary);
+            WriteToken(arg.op_);
+            Write(*arg.expr_);
+        } else if constexpr (std::is_same_v<Arg, expressions::Binary>) {
+            WriteTag(ExprTag::kBinary);
+            WriteToken(arg.op_);
+            Write(*arg.left_);
+            Write(*arg.right_);
+        } else if constexpr (std::is_same_v<Arg, expressions::Conditional>) {
+            WriteTag(ExprTag::kConditional);
+            Write(*arg.first_);
+            Write(*arg.second_);
+            Write(*arg.third_);
+        } else if constexpr (std::is_same_v<Arg, expressions::Grouping>) {
+            WriteTag(ExprTag::kGrouping);
+            Write(*arg.expr_);
+        } else if constexpr (std::is_same_v<Arg, expressions::Variable>) {
+            WriteTag(ExprTag::kVariable);
+            WriteToken(arg.name_);
+        } else if constexpr (std::is_same_v<Arg, expressions::Assign>) {
+            WriteTag(ExprTag::kAssign);
+            WriteToken(arg.name_);
+            Write(*arg.value_);
+        } else if constexpr (std::is_same_v<Arg, expressions::Logical>) {
+            WriteTag(ExprTag::kLogical);
+            WriteToken(arg.op_);
+            Write(*arg.left_);
+            Write(*arg.right_);
+        } else {
+            throw std::runtime_error("Unexpected expression type.");
+        }
+    }
+
+    template <statements::IsStatement Arg>
+    void operator()(const Arg& arg) {
+        if constexpr (std::is_same_v<Arg, statements::Expression>) {
+            WriteTag(StmtTag::kExpression);
+            WriteDelta(line_, arg.line_);
+            Write(*arg.expr_);
+        } else if constexpr (std::is_same_v<Arg, statements::Print>) {
+            WriteTag(StmtTag::kPrint);
+            WriteDelta(line_, arg.line_);
+            Write(*arg.expr_);
+        } else if constexpr (std::is_same_v<Arg, statements::Var>) {
+            WriteTag(StmtTag::kVar);
+            WriteToken(arg.name_);
+            data_ += static_cast<char>(arg.initializer_ != nullptr);
+            if (arg.initializer_ != nullptr) {
+                Write(*arg.initializer_);
+            }
+        } else if constexpr (std::is_same_v<Arg, statements::Block>) {
+            WriteTag(StmtTag::kBlock);
+            WriteDelta(line_, arg.line_);
+            WriteUint(arg.statements_.size());
+            for (const auto& statement : arg.statements_) {
+                Write(statement);
+            }
+        } else if constexpr (std::is_same_v<Arg, statements::If>) {
+            WriteTag(StmtTag::kIf);
+            WriteDelta(line_, arg.line_);
+            Write(*arg.condition_);
+            Write(*arg.then_branch_);
+            data_ += static_cast<char>(arg.else_branch_ != nullptr);
+            if (arg.else_branch_ != nullptr) {
+                Write(*arg.else_branch_);
+            }
+        } else if constexpr (std::is_same_v<Arg, statements::While>) {
+            WriteTag(StmtTag::kWhile);
+            WriteDelta(line_, arg.line_);
+            Write(*arg.condition_);
+            Write(*arg.statement_);
+        } else {
+            throw std::runtime_error("Unexpected statement type.");
+        }
+    }
+
+ private:
+    void Write(const expressions::Expr& expr) {
+        expr.Accept(*this);
+    }
+
+    void Write(const statements::Stmt& stmt) {
+        stmt.Accept(*this);
+    }
+
+    template <typename Tag>
+    void WriteTag(Tag tag) {
+        data_ += static_cast<char>(tag);
+    }
+
+    void WriteToken(const tokens::Token& token) {
+        data_ += static_cast<char>(token.GetType());
+        WriteDelta(offset_, token.GetOffset());
+        WriteUint(token.GetLength());
+        WriteDelta(line_, token.GetLine());
+        if (HasName(token.GetType())) {
+            WriteName(symbols_.GetName(token.GetSymbol()));
+        }
+    }
+
+    void WriteName(std::string_view name) {
+        auto [it, inserted] = name_ids_.try_emplace(name, names_.size());
+        if (inserted) {
+            names_.push_back(name);
+        }
+        WriteUint(it->second);
+    }
+
+    void WriteDelta(uint32_t& previous, uint32_t value) {
+        auto delta = static_cast<int64_t>(value) - previous;
+        WriteUint(static_cast<uint64_t>(delta) << 1 ^ static_cast<uint64_t>(delta >> 63));
+        previous = value;
+    }
+
+    void WriteUint(uint64_t value) {
+        while (value >= 0x80) {
+            data_ += static_cast<char>(value | 0x80);
+            value >>= 7;
+        }
+        data_ += static_cast<char>(value);
+    }
+
+ private:
+    const tokens::SymbolTable& symbols_;
+    std::string data_;
+    // Point into the SymbolTable
+    std::vector<std::string_view> names_;
+    std::unordered_map<std::string_view, uint32_t> name_ids_;
+    // Of the last token written
+    uint32_t offset_ = 0;
+    uint32_t line_ = 0;
+};
+
+// Checks every read against the end of the data, malformed input throws std::runtime_error
+class AstReader {
+ public:
+    AstReader(std::string_view data, Arena& arena, tokens::SymbolTable& symbols, ConstantPool& constants)
+        : data_(data), arena_(arena), symbols_(symbols), constants_(constants) {
+    }
+
+    std::vector<statements::Stmt> Read() {
+        auto names_count = ReadCount();
+        names_.reserve(names_count);
+        for (size_t i = 0; i < names_count; ++i) {
+            auto length = ReadCount();
+            names_.push_back(symbols_.Intern(data_.substr(position_, length)));
+            position_ += length;
+        }
+
+        auto statements = ReadStatements();
+        if (position_ != data_.size()) {
+            throw std::runtime_error("Trailing data.");
+        }
+        return statements;
+    }
+
+ private:
+    expressions::ExprPtr ReadExpr() {
+        switch (static_cast<ExprTag>(ReadByte())) {
+            case ExprTag::kString: {
+                auto symbol = ReadName();
+                const auto& constant = constants_.GetString(symbol);
+                return expressions::MakeExpr<expressions::String>(arena_, symbols_.GetName(symbol), constant);
+            }
+            case ExprTag::kNumber: {
+                uint64_t bits = 0;
+                for (int i = 0; i < 8; ++i) {
+                    bits |= static_cast<uint64_t>(ReadByte()) << (8 * i);
+                }
+                return expressions::MakeExpr<expressions::Number>(arena_, std::bit_cast<double>(bits));
+            }
+            case ExprTag::kInteger: {
+                auto value = ReadUint();
+                if (value > kMaxInteger) {
+                    throw std::runtime_error("Integer too large.");
+                }
+                return expressions::MakeExpr<expressions::Number>(arena_, static_cast<double>(value));
+            }
+            case ExprTag::kBoolean:
+                return expressions::MakeExpr<expressions::Boolean>(arena_, ReadByte() != 0);
+            case ExprTag::kNil:
+                return expressions::MakeExpr<expressions::Nil>(arena_);
+            case ExprTag::kUnary: {
+                auto op = ReadToken(ExprTag::kUnary);
+                return expressions::MakeExpr<expressions::Unary>(arena_, ReadExpr(), std::move(op));
+            }
+            case ExprTag::kBinary: {
+                auto op = ReadToken(ExprTag::kBinary);
+                auto left = ReadExpr();
+                return expressions::MakeExpr<expressions::Binary>(arena_, left, ReadExpr(), std::move(op));
+            }
+            case ExprTag::kConditional: {
+                auto first = ReadExpr();
+                auto second = ReadExpr();
+                return expressions::MakeExpr<expressions::Conditional>(arena_, first, second, ReadExpr());
+            }
+            case ExprTag::kGrouping:
+                return expressions::MakeExpr<expressions::Grouping>(arena_, ReadExpr());
+            case ExprTag::kVariable:
+                return expressions::MakeExpr<expressions::Variable>(arena_, ReadToken(ExprTag::kVariable));
+            case ExprTag::kAssign: {
+                auto name = ReadToken(ExprTag::kAssign);
+                return expressions::MakeExpr<expressions::Assign>(arena_, name, ReadExpr());
+            }
+            case ExprTag::kLogical: {
+                auto op = ReadToken(ExprTag::kLogical);
+                auto left = ReadExpr();
+                return expressions::MakeExpr<expressions::Logical>(arena_, left, ReadExpr(), std::move(op));
+            }
+        }
+        throw std::runtime_error("Unknown expression tag.");
+    }
+
+    statements::Stmt ReadStmt() {
+        switch (static_cast<StmtTag>(ReadByte())) {
+            case StmtTag::kExpression: {
+                auto line = ReadDelta(line_);
+                return statements::MakeStmt<statements::Expression>(ReadExpr(), line);
+            }
+            case StmtTag::kPrint: {
+                auto line = ReadDelta(line_);
+                return statements::MakeStmt<statements::Print>(ReadExpr(), line);
+            }
+            case StmtTag::kVar: {
+                auto name = ReadToken(ExprTag::kVariable);
+                auto initializer = ReadByte() != 0 ? ReadExpr() : nullptr;
+                return statements::MakeStmt<statements::Var>(std::move(name), initializer);
+            }
+            case StmtTag::kBlock: {
+                auto line = ReadDelta(line_);
+                return statements::MakeStmt<statements::Block>(arena_.MakeArray(ReadStatements()), line);
+            }
+            case StmtTag::kIf: {
+                auto line = ReadDelta(line_);
+                auto condition = ReadExpr();
+                auto then_branch = arena_.Make<statements::Stmt>(ReadStmt());
+                auto else_branch = ReadByte() != 0 ? arena_.Make<statements::Stmt>(ReadStmt()) : nullptr;
+                return statements::MakeStmt<statements::If>(condition, then_branch, else_branch, line);
+            }
+            case StmtTag::kWhile: {
+                auto line = ReadDelta(line_);
+                auto condition = ReadExpr();
+                return statements::MakeStmt<statements::While>(condition, arena_.Make<statements::Stmt>(ReadStmt()),
+                                                               line);
+            }
+        }
+        throw std::runtime_error("Unknown statement tag.");
+    }
+
+    std::vector<statements::Stmt> ReadStatements() {
+        std::vector<statements::Stmt> statements(ReadCount());
+        for (auto& statement : statements) {
+            statement = ReadStmt();
+        }
+        return statements;
+    }
+
+    // `tag` is the node the token belongs to, names of variables are read as kVariable
+    tokens::Token ReadToken(ExprTag tag) {
+        auto type = static_cast<tokens::Type>(ReadByte());
+        if (!IsValidToken(tag, type)) {
+            throw std::runtime_error("Unexpected token type.");
+        }
+        auto offset = ReadDelta(offset_);
+        auto length = ReadUint32();
+        if (length > tokens::Token::kMaxLength) {
+            throw std::runtime_error("Token too long.");
+        }
+        auto line = ReadDelta(line_);
+        return tokens::Token(type, offset, length, line, HasName(type) ? ReadName() : tokens::Symbol{});
+    }
+
+    tokens::Symbol ReadName() {
+        auto index = ReadUint32();
+        if (index >= names_.size()) {
+            throw std::runtime_error("Unknown name.");
+        }
+        return names_[index];
+    }
+
+    // Every element takes at least a byte, which bounds what a corrupt count can allocate
+    size_t ReadCount() {
+        auto count = ReadUint();
+        if (count > data_.size() - position_) {
+            throw std::runtime_error("Count past the end.");
+        }
+        return count;
+    }
+
+    uint32_t ReadDelta(uint32_t& previous) {
+        auto encoded = ReadUint();
+        auto value = static_cast<int64_t>(previous) + static_cast<int64_t>(encoded >> 1 ^ -(encoded & 1));
+        if (value < 0 || value > UINT32_MAX) {
+            throw std::runtime_error("Position out of range.");
+        }
+        previous = static_cast<uint32_t>(value);
+        return previous;
+    }
+
+    uint32_t ReadUint32() {
+        auto value = ReadUint();
+        if (value > UINT32_MAX) {
+            throw std::runtime_error("Integer too large.");
+        }
+        return static_cast<uint32_t>(value);
+    }
+
+    uint64_t ReadUint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            auto byte = ReadByte();
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        throw std::runtime_error("Integer too long.");
+    }
+
+    uint8_t ReadByte() {
+        if (position_ == data_.size()) {
+            throw std::runtime_error("Unexpected end of data.");
+        }
+        return static_cast<uint8_t>(data_[position_++]);
+    }
+
+ private:
+    std::string_view data_;
+    size_t position_ = 0;
+    // Of the last token read
+    uint32_t offset_ = 0;
+    uint32_t line_ = 0;
+    Arena& arena_;
+    tokens::SymbolTable& symbols_;
+    ConstantPool& constants_;
+    std::vector<tokens::Symbol> names_;
+};
+
+}  // namespace
+
+std::string SerializeAst(std::span<const statements::Stmt> statements, const tokens::SymbolTable& symbols) {
+    return AstWriter(symbols).Write(statements);
+}
+
+std::optional<std::vector<statements::Stmt>> DeserializeAst(std::string_view data, Arena& arena,
+                                                            tokens::SymbolTable& symbols, ConstantPool& constants) {
+    try {
+        return AstReader(data, arena, symbols, constants).Read();
+    } catch (const std::runtime_error&) {
+        return std::nullopt;
+    }
+}
+
+}  // namespace lox
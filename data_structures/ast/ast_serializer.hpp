@@ -0,0 +1,24 @@
+#pragma once
+
+#include <data_structures/arena/arena.hpp>
+#include <data_structures/ast/constant_pool.hpp>
+#include <data_structures/ast/statements.hpp>
+#include <data_structures/tokens/symbols.hpp>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lox {
+
+// Compact binary encoding of a parsed program, before it is folded or resolved.
+// Names and string literals are stored as text, so symbols can be interned again by any table.
+// Tokens keep their position in the source, which is only valid for the same source.
+std::string SerializeAst(std::span<const statements::Stmt> statements, const tokens::SymbolTable& symbols);
+
+// Rebuilds the program in `arena`, returns std::nullopt if `data` is malformed
+std::optional<std::vector<statements::Stmt>> DeserializeAst(std::string_view data, Arena& arena,
+                                                            tokens::SymbolTable& symbols, ConstantPool& constants);
+
+}  // namespace lox
@@ -0,0 +1,236 @@
+#include "closure_interpreter.hpp"
+
+#include <lox/errors.hpp>
+#include <lox/lox.hpp>
+
+namespace lox {
+
+namespace {
+
+struct Divide {
+    double operator()(double lhs, double rhs) const {
+        return lhs / rhs;
+    }
+};
+
+}  // namespace
+
+ClosureInterpreter::ClosureInterpreter(Lox& lox)
+    : globals_(lox.GetSymbols()), locals_(lox.GetSymbols()), output_(lox.GetOutput()), lox_(lox) {
+}
+
+void ClosureInterpreter::Interpret(const std::vector<statements::Stmt>& statements) {
+    std::vector<StmtClosure> program;
+    program.reserve(statements.size());
+    for (const auto& statement : statements) {
+        program.push_back(Compile(statement));
+    }
+
+    try {
+        for (const auto& statement : program) {
+            statement();
+        }
+    } catch (const RuntimeError& error) {
+        lox_.RuntimeError(error);
+    }
+}
+
+ClosureInterpreter::ExprClosure ClosureInterpreter::Compile(const expressions::Expr& expr) {
+    return expr.Accept(*this);
+}
+
+ClosureInterpreter::StmtClosure ClosureInterpreter::Compile(const statements::Stmt& stmt) {
+    return stmt.Accept(*this);
+}
+
+ClosureInterpreter::ExprClosure ClosureInterpreter::CompileUnary(const expressions::Unary& expr) {
+    auto operand = Compile(*expr.expr_);
+    if (expr.op_.GetType() == tokens::Type::kMinus) {
+        return [operand = std::move(operand), op = expr.op_] {
+            auto value = operand();
+            if (!value.Is<double>()) {
+                throw RuntimeError(op, "Operand must be a number.");
+            }
+            return Value(-value.As<double>());
+        };
+    } else if (expr.op_.GetType() == tokens::Type::kBang) {
+        return [operand = std::move(operand)] {
+            return Value(!IsTruthy(operand()));
+        };
+    }
+    return operand;
+}
+
+ClosureInterpreter::ExprClosure ClosureInterpreter::CompileBinary(const expressions::Binary& expr) {
+    switch (expr.op_.GetType()) {
+        case tokens::Type::kMinus:
+            return CompileNumberOperation<std::minus<double>>(expr);
+        case tokens::Type::kStar:
+            return CompileNumberOperation<std::multiplies<double>>(expr);
+        case tokens::Type::kSlash:
+            return CompileNumberOperation<Divide>(expr);
+        case tokens::Type::kGreater:
+            return CompileNumberOperation<std::greater<double>>(expr);
+        case tokens::Type::kGreaterEqual:
+            return CompileNumberOperation<std::greater_equal<double>>(expr);
+        case tokens::Type::kLess:
+            return CompileNumberOperation<std::less<double>>(expr);
+        case tokens::Type::kLessEqual:
+            return CompileNumberOperation<std::less_equal<double>>(expr);
+        default:
+            break;
+    }
+
+    auto left = Compile(*expr.left_);
+    auto right = Compile(*expr.right_);
+    switch (expr.op_.GetType()) {
+        case tokens::Type::kPlus:
+            return [left = std::move(left), right = std::move(right), op = expr.op_] {
+                auto lhs = left();
+                auto rhs = right();
+                if (lhs.Is<double>() && rhs.Is<double>()) {
+                    return Value(lhs.As<double>() + rhs.As<double>());
+                } else if (lhs.Is<std::string>() && rhs.Is<std::string>()) {
+                    return Value::Concatenate(lhs, rhs);
+                }
+                throw RuntimeError(op, "Operands must be two numbers or two strings.");
+            };
+        case tokens::Type::kEqualEqual:
+            return [left = std::move(left), right = std::move(right)] {
+                auto lhs = left();
+                return Value(lhs == right());
+            };
+        case tokens::Type::kBangEqual:
+            return [left = std::move(left), right = std::move(right)] {
+                auto lhs = left();
+                return Value(lhs != right());
+            };
+        default:
+            // The comma operator
+            return [left = std::move(left), right = std::move(right)] {
+                left();
+                return right();
+            };
+    }
+}
+
+template <typename Operation>
+ClosureInterpreter::ExprClosure ClosureInterpreter::CompileNumberOperation(const expressions::Binary& expr) {
+    return [left = Compile(*expr.left_), right = Compile(*expr.right_), op = expr.op_] {
+        auto lhs = left();
+        auto rhs = right();
+        if (!lhs.Is<double>() || !rhs.Is<double>()) {
+            throw RuntimeError(op, "Operands must be numbers.");
+        }
+        if constexpr (std::is_same_v<Operation, Divide>) {
+            if (rhs.As<double>() == 0) {
+                throw RuntimeError(op, "Division by zero.");
+            }
+        }
+        return Value(Operation{}(lhs.As<double>(), rhs.As<double>()));
+    };
+}
+
+ClosureInterpreter::ExprClosure ClosureInterpreter::CompileVariable(const expressions::Variable& expr) {
+    if (expr.slot_.has_value()) {
+        return [this, name = expr.name_, slot = *expr.slot_] {
+            return locals_.Get(name, slot);
+        };
+    }
+    return [this, name = expr.name_] {
+        return globals_.Get(name);
+    };
+}
+
+ClosureInterpreter::ExprClosure ClosureInterpreter::CompileAssign(const expressions::Assign& expr) {
+    auto value = Compile(*expr.value_);
+    if (expr.slot_.has_value()) {
+        return [this, value = std::move(value), slot = *expr.slot_] {
+            auto result = value();
+            locals_.Assign(slot, result);
+            return result;
+        };
+    }
+    return [this, value = std::move(value), name = expr.name_] {
+        auto result = value();
+        globals_.Assign(name, result);
+        return result;
+    };
+}
+
+ClosureInterpreter::ExprClosure ClosureInterpreter::CompileLogical(const expressions::Logical& expr) {
+    // The left operand is the result when it decides the outcome
+    bool is_or = expr.op_.GetType() == tokens::Type::kOr;
+    return [left = Compile(*expr.left_), right = Compile(*expr.right_), is_or] {
+        auto lhs = left();
+        if (IsTruthy(lhs) == is_or) {
+            return lhs;
+        }
+        return right();
+    };
+}
+
+ClosureInterpreter::StmtClosure ClosureInterpreter::CompileVar(const statements::Var& stmt) {
+    ExprClosure initializer;
+    if (stmt.initializer_ != nullptr) {
+        initializer = Compile(*stmt.initializer_);
+    } else {
+        initializer = [] {
+            return Value();
+        };
+    }
+
+    if (stmt.slot_.has_value()) {
+        return [this, initializer = std::move(initializer), slot = *stmt.slot_] {
+            locals_.Define(slot, initializer());
+        };
+    }
+    return [this, initializer = std::move(initializer), name = stmt.name_.GetSymbol()] {
+        globals_.Define(name, initializer());
+    };
+}
+
+ClosureInterpreter::StmtClosure ClosureInterpreter::CompileBlock(const statements::Block& stmt) {
+    std::vector<StmtClosure> statements;
+    statements.reserve(stmt.statements_.size());
+    for (const auto& statement : stmt.statements_) {
+        statements.push_back(Compile(statement));
+    }
+    return [this, statements = std::move(statements), slots_count = stmt.slots_count_] {
+        ScopeGuard guard(&locals_, slots_count);
+        for (const auto& statement : statements) {
+            statement();
+        }
+    };
+}
+
+ClosureInterpreter::StmtClosure ClosureInterpreter::CompileIf(const statements::If& stmt) {
+    auto condition = Compile(*stmt.condition_);
+    auto then_branch = Compile(*stmt.then_branch_);
+    if (stmt.else_branch_ == nullptr) {
+        return [condition = std::move(condition), then_branch = std::move(then_branch)] {
+            if (IsTruthy(condition())) {
+                then_branch();
+            }
+        };
+    }
+    return [condition = std::move(condition), then_branch = std::move(then_branch),
+            else_branch = Compile(*stmt.else_branch_)] {
+        if (IsTruthy(condition())) {
+            then_branch();
+        } else {
+            else_branch();
+        }
+    };
+}
+
+bool ClosureInterpreter::IsTruthy(const Value& value) {
+    if (value.Is<std::monostate>()) {
+        return false;
+    } else if (value.Is<bool>()) {
+        return value.As<bool>();
+    }
+    return true;
+}
+
+}  // namespace lox
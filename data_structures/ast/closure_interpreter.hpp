@@ -0,0 +1,110 @@
+#pragma once
+
+#include <data_structures/ast/expressions.hpp>
+#include <data_structures/ast/statements.hpp>
+#include <data_structures/ast/value.hpp>
+#include <data_structures/environment/environment.hpp>
+#include <functional>
+#include <lox/output_sink.hpp>
+#include <vector>
+
+namespace lox {
+
+class Lox;
+
+// Compiles each node once into a closure with its operator, literal and variable location bound ahead of time,
+// so running the program never visits a variant or inspects a token. Same semantics as AstInterpreter.
+class ClosureInterpreter {
+ public:
+    using ExprClosure = std::function<Value()>;
+    using StmtClosure = std::function<void()>;
+
+    explicit ClosureInterpreter(Lox& lox);
+    // The statements must be resolved
+    void Interpret(const std::vector<statements::Stmt>& statements);
+
+    template <expressions::IsExpression Arg>
+    ExprClosure operator()(const Arg& arg) {
+        if constexpr (std::is_same_v<Arg, expressions::String>) {
+            return [value = *arg.constant_] {
+                return value;
+            };
+        } else if constexpr (expressions::IsLiteral<Arg>) {
+            return [value = Value(arg.value_)] {
+                return value;
+            };
+        } else if constexpr (std::is_same_v<Arg, expressions::Unary>) {
+            return CompileUnary(arg);
+        } else if constexpr (std::is_same_v<Arg, expressions::Binary>) {
+            return CompileBinary(arg);
+        } else if constexpr (std::is_same_v<Arg, expressions::Conditional>) {
+            return [condition = Compile(*arg.first_), then_branch = Compile(*arg.second_),
+                    else_branch = Compile(*arg.third_)] {
+                return IsTruthy(condition()) ? then_branch() : else_branch();
+            };
+        } else if constexpr (std::is_same_v<Arg, expressions::Grouping>) {
+            return Compile(*arg.expr_);
+        } else if constexpr (std::is_same_v<Arg, expressions::Variable>) {
+            return CompileVariable(arg);
+        } else if constexpr (std::is_same_v<Arg, expressions::Assign>) {
+            return CompileAssign(arg);
+        } else if constexpr (std::is_same_v<Arg, expressions::Logical>) {
+            return CompileLogical(arg);
+        } else {
+            throw std::runtime_error("Unexpected expression type.");
+        }
+    }
+
+    template <statements::IsStatement Arg>
+    StmtClosure operator()(const Arg& arg) {
+        if constexpr (std::is_same_v<Arg, statements::Print>) {
+            return [this, expr = Compile(*arg.expr_)] {
+                expr().Print(output_);
+                output_.EndLine();
+            };
+        } else if constexpr (std::is_same_v<Arg, statements::Expression>) {
+            return [expr = Compile(*arg.expr_)] {
+                expr();
+            };
+        } else if constexpr (std::is_same_v<Arg, statements::Var>) {
+            return CompileVar(arg);
+        } else if constexpr (std::is_same_v<Arg, statements::Block>) {
+            return CompileBlock(arg);
+        } else if constexpr (std::is_same_v<Arg, statements::If>) {
+            return CompileIf(arg);
+        } else if constexpr (std::is_same_v<Arg, statements::While>) {
+            return [condition = Compile(*arg.condition_), body = Compile(*arg.statement_)] {
+                while (IsTruthy(condition())) {
+                    body();
+                }
+            };
+        } else {
+            throw std::runtime_error("Unexpected statement type.");
+        }
+    }
+
+ private:
+    ExprClosure Compile(const expressions::Expr& expr);
+    StmtClosure Compile(const statements::Stmt& stmt);
+    ExprClosure CompileUnary(const expressions::Unary& expr);
+    ExprClosure CompileBinary(const expressions::Binary& expr);
+    // For the operators that take two numbers
+    template <typename Operation>
+    ExprClosure CompileNumberOperation(const expressions::Binary& expr);
+    ExprClosure CompileVariable(const expressions::Variable& expr);
+    ExprClosure CompileAssign(const expressions::Assign& expr);
+    ExprClosure CompileLogical(const expressions::Logical& expr);
+    StmtClosure CompileVar(const statements::Var& stmt);
+    StmtClosure CompileBlock(const statements::Block& stmt);
+    StmtClosure CompileIf(const statements::If& stmt);
+
+    static bool IsTruthy(const Value& value);
+
+ private:
+    Environment globals_;
+    LocalScopes locals_;
+    OutputSink& output_;
+    Lox& lox_;
+};
+
+}  // namespace lox
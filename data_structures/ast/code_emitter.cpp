@@ -0,0 +1,428 @@
+#include "code_emitter.hpp"
+
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <string_view>
+
+namespace lox {
+
+namespace {
+
+// Mirrors Value, Environment and FormatNumber, including the interpreter's error messages
+constexpr std::string_view kRuntime = R"(// Generated by lox --emit-c, build with: c++ -std=c++17 -O2
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+namespace {
+
+enum class Type { kUndefined, kUninitialized, kNil, kBool, kNumber, kString };
+
+struct Value {
+    Type type = Type::kUninitialized;
+    bool boolean = false;
+    double number = 0;
+    std::shared_ptr<const std::string> string;
+};
+
+[[noreturn]] void Fail(unsigned line, const std::string& message) {
+    std::fflush(stdout);
+    std::fprintf(stderr, "[line %u] %s\n", line, message.c_str());
+    std::exit(70);
+}
+
+Value Nil() {
+    Value value;
+    value.type = Type::kNil;
+    return value;
+}
+
+Value Bool(bool boolean) {
+    Value value;
+    value.type = Type::kBool;
+    value.boolean = boolean;
+    return value;
+}
+
+Value Number(double number) {
+    Value value;
+    value.type = Type::kNumber;
+    value.number = number;
+    return value;
+}
+
+Value NumberBits(uint64_t bits) {
+    double number;
+    std::memcpy(&number, &bits, sizeof(number));
+    return Number(number);
+}
+
+Value String(std::string string) {
+    Value value;
+    value.type = Type::kString;
+    value.string = std::make_shared<const std::string>(std::move(string));
+    return value;
+}
+
+bool Truthy(const Value& value) {
+    return value.type == Type::kBool ? value.boolean : value.type != Type::kNil;
+}
+
+bool Equal(const Value& lhs, const Value& rhs) {
+    if (lhs.type != rhs.type) {
+        return false;
+    } else if (lhs.type == Type::kBool) {
+        return lhs.boolean == rhs.boolean;
+    } else if (lhs.type == Type::kNumber) {
+        return lhs.number == rhs.number;
+    } else if (lhs.type == Type::kString) {
+        return *lhs.string == *rhs.string;
+    }
+    return true;
+}
+
+Value Negate(const Value& value, unsigned line) {
+    if (value.type != Type::kNumber) {
+        Fail(line, "Operand must be a number.");
+    }
+    return Number(-value.number);
+}
+
+void CheckNumbers(const Value& lhs, const Value& rhs, unsigned line) {
+    if (lhs.type != Type::kNumber || rhs.type != Type::kNumber) {
+        Fail(line, "Operands must be numbers.");
+    }
+}
+
+Value Add(const Value& lhs, const Value& rhs, unsigned line) {
+    if (lhs.type == Type::kNumber && rhs.type == Type::kNumber) {
+        return Number(lhs.number + rhs.number);
+    } else if (lhs.type == Type::kString && rhs.type == Type::kString) {
+        return String(*lhs.string + *rhs.string);
+    }
+    Fail(line, "Operands must be two numbers or two strings.");
+}
+
+Value Subtract(const Value& lhs, const Value& rhs, unsigned line) {
+    CheckNumbers(lhs, rhs, line);
+    return Number(lhs.number - rhs.number);
+}
+
+Value Multiply(const Value& lhs, const Value& rhs, unsigned line) {
+    CheckNumbers(lhs, rhs, line);
+    return Number(lhs.number * rhs.number);
+}
+
+Value Divide(const Value& lhs, const Value& rhs, unsigned line) {
+    CheckNumbers(lhs, rhs, line);
+    if (rhs.number == 0) {
+        Fail(line, "Division by zero.");
+    }
+    return Number(lhs.number / rhs.number);
+}
+
+Value Greater(const Value& lhs, const Value& rhs, unsigned line) {
+    CheckNumbers(lhs, rhs, line);
+    return Bool(lhs.number > rhs.number);
+}
+
+Value GreaterEqual(const Value& lhs, const Value& rhs, unsigned line) {
+    CheckNumbers(lhs, rhs, line);
+    return Bool(lhs.number >= rhs.number);
+}
+
+Value Less(const Value& lhs, const Value& rhs, unsigned line) {
+    CheckNumbers(lhs, rhs, line);
+    return Bool(lhs.number < rhs.number);
+}
+
+Value LessEqual(const Value& lhs, const Value& rhs, unsigned line) {
+    CheckNumbers(lhs, rhs, line);
+    return Bool(lhs.number <= rhs.number);
+}
+
+const Value& Read(const Value& variable, unsigned line, const char* name) {
+    if (variable.type == Type::kUndefined) {
+        Fail(line, "Undefined variable '" + std::string(name) + "'.");
+    } else if (variable.type == Type::kUninitialized) {
+        Fail(line, "Access to uninitialized variable '" + std::string(name) + "'.");
+    }
+    return variable;
+}
+
+void Assign(Value& variable, const Value& value, unsigned line, const char* name) {
+    if (variable.type == Type::kUndefined) {
+        Fail(line, "Undefined variable '" + std::string(name) + "'.");
+    }
+    variable = value;
+}
+
+void Print(const Value& value) {
+    if (value.type == Type::kNumber) {
+        // Shortest round trip, without an exponent from 1e-7 up to 1e21
+        char buffer[32];
+        auto magnitude = std::fabs(value.number);
+        auto format = magnitude == 0 || (magnitude >= 1e-7 && magnitude < 1e21) ? std::chars_format::fixed
+                                                                                 : std::chars_format::scientific;
+        auto end = std::to_chars(buffer, buffer + sizeof(buffer), value.number, format).ptr;
+        std::fwrite(buffer, 1, end - buffer, stdout);
+    } else if (value.type == Type::kString) {
+        std::fwrite(value.string->data(), 1, value.string->size(), stdout);
+    } else if (value.type == Type::kBool) {
+        std::fputs(value.boolean ? "true" : "false", stdout);
+    } else {
+        std::fputs("nil", stdout);
+    }
+    std::putchar('\n');
+}
+
+)";
+
+}  // namespace
+
+CodeEmitter::CodeEmitter(const tokens::SymbolTable& symbols) : symbols_(symbols) {
+}
+
+std::string CodeEmitter::Emit(std::span<const statements::Stmt> statements) {
+    indent_ = 1;
+    for (const auto& statement : statements) {
+        Emit(statement);
+    }
+
+    std::string result(kRuntime);
+    for (size_t i = 0; i < strings_.size(); ++i) {
+        result += "const Value s" + std::to_string(i) + " = String(std::string(" + EscapeString(strings_[i]) +
+                  ", " + std::to_string(strings_[i].size()) + "));\n";
+    }
+    for (auto global : globals_) {
+        result += "Value g" + std::to_string(global) + "{Type::kUndefined};\n";
+    }
+    result += "\n}  // namespace\n\nint main() {\n";
+    result += code_;
+    result += "    return 0;\n}\n";
+    return result;
+}
+
+std::string CodeEmitter::Emit(const expressions::Expr& expr) {
+    return expr.Accept(*this);
+}
+
+void CodeEmitter::Emit(const statements::Stmt& stmt) {
+    stmt.Accept(*this);
+}
+
+std::string CodeEmitter::EmitString(const expressions::String& expr) {
+    auto [it, inserted] = string_ids_.try_emplace(expr.constant_, strings_.size());
+    if (inserted) {
+        strings_.push_back(expr.value_);
+    }
+    return "s" + std::to_string(it->second);
+}
+
+std::string CodeEmitter::EmitUnary(const expressions::Unary& expr) {
+    auto operand = Emit(*expr.expr_);
+    if (expr.op_.GetType() == tokens::Type::kMinus) {
+        return Define("Negate(" + operand + ", " + std::to_string(expr.op_.GetLine()) + ")");
+    } else if (expr.op_.GetType() == tokens::Type::kBang) {
+        return Define("Bool(!Truthy(" + operand + "))");
+    }
+    return operand;
+}
+
+std::string CodeEmitter::EmitBinary(const expressions::Binary& expr) {
+    auto lhs = Emit(*expr.left_);
+    auto rhs = Emit(*expr.right_);
+    auto operands = "(" + lhs + ", " + rhs + ", " + std::to_string(expr.op_.GetLine()) + ")";
+    switch (expr.op_.GetType()) {
+        case tokens::Type::kPlus:
+            return Define("Add" + operands);
+        case tokens::Type::kMinus:
+            return Define("Subtract" + operands);
+        case tokens::Type::kStar:
+            return Define("Multiply" + operands);
+        case tokens::Type::kSlash:
+            return Define("Divide" + operands);
+        case tokens::Type::kGreater:
+            return Define("Greater" + operands);
+        case tokens::Type::kGreaterEqual:
+            return Define("GreaterEqual" + operands);
+        case tokens::Type::kLess:
+            return Define("Less" + operands);
+        case tokens::Type::kLessEqual:
+            return Define("LessEqual" + operands);
+        case tokens::Type::kEqualEqual:
+            return Define("Bool(Equal(" + lhs + ", " + rhs + "))");
+        case tokens::Type::kBangEqual:
+            return Define("Bool(!Equal(" + lhs + ", " + rhs + "))");
+        default:
+            // The comma operator
+            return rhs;
+    }
+}
+
+std::string CodeEmitter::EmitConditional(const expressions::Conditional& expr) {
+    auto condition = Emit(*expr.first_);
+    auto result = Define("Value()");
+    Line("if (Truthy(" + condition + ")) {");
+    ++indent_;
+    Line(result + " = " + Emit(*expr.second_) + ";");
+    --indent_;
+    Line("} else {");
+    ++indent_;
+    Line(result + " = " + Emit(*expr.third_) + ";");
+    --indent_;
+    Line("}");
+    return result;
+}
+
+std::string CodeEmitter::EmitVariable(const expressions::Variable& expr) {
+    auto variable = expr.slot_.has_value() ? Local(*expr.slot_) : Global(expr.name_);
+    // Copied, so a later assignment in the same expression doesn't change it
+    return Define("Read(" + variable + ", " + std::to_string(expr.name_.GetLine()) + ", " +
+                  Quote(expr.name_.GetSymbol()) + ")");
+}
+
+std::string CodeEmitter::EmitAssign(const expressions::Assign& expr) {
+    auto value = Emit(*expr.value_);
+    if (expr.slot_.has_value()) {
+        Line(Local(*expr.slot_) + " = " + value + ";");
+    } else {
+        Line("Assign(" + Global(expr.name_) + ", " + value + ", " + std::to_string(expr.name_.GetLine()) + ", " +
+             Quote(expr.name_.GetSymbol()) + ");");
+    }
+    return value;
+}
+
+std::string CodeEmitter::EmitLogical(const expressions::Logical& expr) {
+    // The left operand is the result when it decides the outcome
+    bool is_or = expr.op_.GetType() == tokens::Type::kOr;
+    auto result = Define(Emit(*expr.left_));
+    Line(std::string(is_or ? "if (!Truthy(" : "if (Truthy(") + result + ")) {");
+    ++indent_;
+    Line(result + " = " + Emit(*expr.right_) + ";");
+    --indent_;
+    Line("}");
+    return result;
+}
+
+void CodeEmitter::EmitVar(const statements::Var& stmt) {
+    auto value = stmt.initializer_ != nullptr ? Emit(*stmt.initializer_) : "Value()";
+    if (stmt.slot_.has_value()) {
+        Line(Local({0, *stmt.slot_}) + " = " + value + ";");
+    } else {
+        Line(Global(stmt.name_) + " = " + value + ";");
+    }
+}
+
+void CodeEmitter::EmitBlock(const statements::Block& stmt) {
+    blocks_.push_back(blocks_count_++);
+    Line("{");
+    ++indent_;
+    // Every variable of the block starts out uninitialized on each entry
+    for (uint32_t i = 0; i < stmt.slots_count_; ++i) {
+        Line("Value " + Local({0, i}) + ";");
+    }
+    for (const auto& statement : stmt.statements_) {
+        Emit(statement);
+    }
+    --indent_;
+    Line("}");
+    blocks_.pop_back();
+}
+
+void CodeEmitter::EmitIf(const statements::If& stmt) {
+    Line("if (Truthy(" + Emit(*stmt.condition_) + ")) {");
+    EmitNested(*stmt.then_branch_);
+    if (stmt.else_branch_ != nullptr) {
+        Line("} else {");
+        EmitNested(*stmt.else_branch_);
+    }
+    Line("}");
+}
+
+void CodeEmitter::EmitWhile(const statements::While& stmt) {
+    Line("while (true) {");
+    ++indent_;
+    Line("if (!Truthy(" + Emit(*stmt.condition_) + ")) {");
+    Line("    break;");
+    Line("}");
+    --indent_;
+    EmitNested(*stmt.statement_);
+    Line("}");
+}
+
+void CodeEmitter::EmitNested(const statements::Stmt& stmt) {
+    ++indent_;
+    Emit(stmt);
+    --indent_;
+}
+
+std::string CodeEmitter::Define(const std::string& value) {
+    auto name = "t" + std::to_string(temporaries_count_++);
+    Line("Value " + name + " = " + value + ";");
+    return name;
+}
+
+std::string CodeEmitter::Local(expressions::Slot slot) const {
+    return "l" + std::to_string(blocks_[blocks_.size() - 1 - slot.depth_]) + "_" + std::to_string(slot.index_);
+}
+
+std::string CodeEmitter::Global(const tokens::Token& name) {
+    auto index = static_cast<uint32_t>(name.GetSymbol());
+    globals_.insert(index);
+    return "g" + std::to_string(index);
+}
+
+std::string CodeEmitter::Quote(tokens::Symbol name) const {
+    // Identifiers need no escaping
+    return "\"" + symbols_.GetName(name) + "\"";
+}
+
+void CodeEmitter::Line(const std::string& text) {
+    code_.append(4 * indent_, ' ');
+    code_ += text;
+    code_ += '\n';
+}
+
+std::string CodeEmitter::EmitNumber(double value) {
+    if (!std::isfinite(value)) {
+        // Folding can produce infinities and NaNs, which have no literal
+        return "NumberBits(" + std::to_string(std::bit_cast<uint64_t>(value)) + "ull)";
+    }
+    // Hexadecimal literals are exact
+    std::array<char, 32> buffer;
+    auto end = std::to_chars(buffer.data(), buffer.data() + buffer.size(), std::fabs(value),
+                             std::chars_format::hex).ptr;
+    return std::string(std::signbit(value) ? "Number(-0x" : "Number(0x") + std::string(buffer.data(), end) + ")";
+}
+
+std::string CodeEmitter::EscapeString(std::string_view text) {
+    static constexpr std::string_view kDigits = "01234567";
+
+    std::string result = "\"";
+    for (char c : text) {
+        auto byte = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\') {
+            result += '\\';
+            result += c;
+        } else if (byte >= ' ' && byte <= '~') {
+            result += c;
+        } else {
+            // Three octal digits, so a following digit isn't taken as part of the escape
+            result += '\\';
+            result += kDigits[byte >> 6];
+            result += kDigits[(byte >> 3) & 7];
+            result += kDigits[byte & 7];
+        }
+    }
+    return result + "\"";
+}
+
+}  // namespace lox
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstdint>
+#include <data_structures/ast/expressions.hpp>
+#include <data_structures/ast/statements.hpp>
+#include <data_structures/tokens/symbols.hpp>
+#include <set>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lox {
+
+// Translates a program into a self-contained C++ translation unit with a small runtime for dynamic values,
+// to be built into a native executable. It prints the same output and runtime errors as AstInterpreter.
+class CodeEmitter {
+ public:
+    // Variable names are looked up in `symbols`
+    explicit CodeEmitter(const tokens::SymbolTable& symbols);
+    // The statements must be resolved
+    std::string Emit(std::span<const statements::Stmt> statements);
+
+    // Emits the code computing the expression and returns the name holding its value
+    template <expressions::IsExpression Arg>
+    std::string operator()(const Arg& arg) {
+        if constexpr (std::is_same_v<Arg, expressions::String>) {
+            return EmitString(arg);
+        } else if constexpr (std::is_same_v<Arg, expressions::Number>) {
+            return Define(EmitNumber(arg.value_));
+        } else if constexpr (std::is_same_v<Arg, expressions::Boolean>) {
+            return Define(arg.value_ ? "Bool(true)" : "Bool(false)");
+        } else if constexpr (std::is_same_v<Arg, expressions::Nil>) {
+            return Define("Nil()");
+        } else if constexpr (std::is_same_v<Arg, expressions::Unary>) {
+            return EmitUnary(arg);
+        } else if constexpr (std::is_same_v<Arg, expressions::Binary>) {
+            return EmitBinary(arg);
+        } else if constexpr (std::is_same_v<Arg, expressions::Conditional>) {
+            return EmitConditional(arg);
+        } else if constexpr (std::is_same_v<Arg, expressions::Grouping>) {
+            return Emit(*arg.expr_);
+        } else if constexpr (std::is_same_v<Arg, expressions::Variable>) {
+            return EmitVariable(arg);
+        } else if constexpr (std::is_same_v<Arg, expressions::Assign>) {
+            return EmitAssign(arg);
+        } else if constexpr (std::is_same_v<Arg, expressions::Logical>) {
+            return EmitLogical(arg);
+        } else {
+            throw std::runtime_error("Unexpected expression type.");
+        }
+    }
+
+    template <statements::IsStatement Arg>
+    void operator()(const Arg& arg) {
+        if constexpr (std::is_same_v<Arg, statements::Print>) {
+            Line("Print(" + Emit(*arg.expr_) + ");");
+        } else if constexpr (std::is_same_v<Arg, statements::Expression>) {
+            Emit(*arg.expr_);
+        } else if constexpr (std::is_same_v<Arg, statements::Var>) {
+            EmitVar(arg);
+        } else if constexpr (std::is_same_v<Arg, statements::Block>) {
+            EmitBlock(arg);
+        } else if constexpr (std::is_same_v<Arg, statements::If>) {
+            EmitIf(arg);
+        } else if constexpr (std::is_same_v<Arg, statements::While>) {
+            EmitWhile(arg);
+        } else {
+            throw std::runtime_error("Unexpected statement type.");
+        }
+    }
+
+ private:
+    std::string Emit(const expressions::Expr& expr);
+    void Emit(const statements::Stmt& stmt);
+    std::string EmitString(const expressions::String& expr);
+    std::string EmitUnary(const expressions::Unary& expr);
+    std::string EmitBinary(const expressions::Binary& expr);
+    std::string EmitConditional(const expressions::Conditional& expr);
+    std::string EmitVariable(const expressions::Variable& expr);
+    std::string EmitAssign(const expressions::Assign& expr);
+    std::string EmitLogical(const expressions::Logical& expr);
+    void EmitVar(const statements::Var& stmt);
+    void EmitBlock(const statements::Block& stmt);
+    void EmitIf(const statements::If& stmt);
+    void EmitWhile(const statements::While& stmt);
+    // Emits a branch in its own braces, so its temporaries don't leak
+    void EmitNested(const statements::Stmt& stmt);
+
+    // Stores `value` in a new temporary and returns its name
+    std::string Define(const std::string& value);
+    std::string Local(expressions::Slot slot) const;
+    std::string Global(const tokens::Token& name);
+    std::string Quote(tokens::Symbol name) const;
+    void Line(const std::string& text);
+
+    static std::string EmitNumber(double value);
+    // A C++ string literal, every byte outside of printable ASCII is escaped
+    static std::string EscapeString(std::string_view text);
+
+ private:
+    const tokens::SymbolTable& symbols_;
+    std::string code_;
+    uint32_t indent_ = 0;
+    uint32_t temporaries_count_ = 0;
+    uint32_t blocks_count_ = 0;
+    // Ids of the enclosing blocks, innermost last
+    std::vector<uint32_t> blocks_;
+    // Each distinct string literal is made once, in the order they are first used
+    std::unordered_map<const Value*, uint32_t> string_ids_;
+    std::vector<std::string_view> strings_;
+    std::set<uint32_t> globals_;
+};
+
+}  // namespace lox
@@ -0,0 +1,167 @@
+#include "constant_folder.hpp"
+
+#include <algorithm>
+
+namespace lox {
+
+ConstantFolder::ConstantFolder(Arena& arena, tokens::SymbolTable& symbols, ConstantPool& constants)
+    : arena_(arena), symbols_(symbols), constants_(constants) {
+}
+
+void ConstantFolder::Fold(std::vector<statements::Stmt>& statements) {
+    auto left = Fold(std::span<statements::Stmt>(statements));
+    statements.resize(left.size());
+}
+
+void ConstantFolder::Fold(expressions::Expr& expr) {
+    if (auto replacement = expr.Accept(*this); replacement != nullptr) {
+        expr = *replacement;
+    }
+}
+
+void ConstantFolder::Fold(statements::Stmt& stmt) {
+    if (auto replacement = stmt.Accept(*this); replacement != nullptr) {
+        stmt = *replacement;
+    }
+}
+
+std::span<statements::Stmt> ConstantFolder::Fold(std::span<statements::Stmt> statements) {
+    for (auto& statement : statements) {
+        Fold(statement);
+    }
+    auto end = std::remove_if(statements.begin(), statements.end(), IsEmpty);
+    return statements.first(end - statements.begin());
+}
+
+expressions::ExprPtr ConstantFolder::FoldUnary(expressions::Unary& expr) {
+    Fold(*expr.expr_);
+    auto operand = GetConstant(*expr.expr_);
+    if (!operand.has_value()) {
+        return nullptr;
+    }
+    if (expr.op_.GetType() == tokens::Type::kBang) {
+        return MakeConstant(Value(!IsTruthy(*operand)));
+    } else if (expr.op_.GetType() == tokens::Type::kMinus && operand->Is<double>()) {
+        return MakeConstant(Value(-operand->As<double>()));
+    }
+    return nullptr;
+}
+
+expressions::ExprPtr ConstantFolder::FoldBinary(expressions::Binary& expr) {
+    Fold(*expr.left_);
+    Fold(*expr.right_);
+    auto lhs = GetConstant(*expr.left_);
+    auto rhs = GetConstant(*expr.right_);
+    if (!lhs.has_value() || !rhs.has_value()) {
+        return nullptr;
+    }
+
+    auto type = expr.op_.GetType();
+    if (type == tokens::Type::kEqualEqual) {
+        return MakeConstant(Value(*lhs == *rhs));
+    } else if (type == tokens::Type::kBangEqual) {
+        return MakeConstant(Value(*lhs != *rhs));
+    } else if (type == tokens::Type::kPlus && lhs->Is<std::string>() && rhs->Is<std::string>()) {
+        return MakeConstant(Value(lhs->As<std::string>() + rhs->As<std::string>()));
+    } else if (!lhs->Is<double>() || !rhs->Is<double>()) {
+        return nullptr;
+    }
+
+    auto left = lhs->As<double>();
+    auto right = rhs->As<double>();
+    switch (type) {
+        case tokens::Type::kPlus:
+            return MakeConstant(Value(left + right));
+        case tokens::Type::kMinus:
+            return MakeConstant(Value(left - right));
+        case tokens::Type::kStar:
+            return MakeConstant(Value(left * right));
+        case tokens::Type::kSlash:
+            // Division by zero is a runtime error
+            return right == 0 ? nullptr : MakeConstant(Value(left / right));
+        case tokens::Type::kGreater:
+            return MakeConstant(Value(left > right));
+        case tokens::Type::kGreaterEqual:
+            return MakeConstant(Value(left >= right));
+        case tokens::Type::kLess:
+            return MakeConstant(Value(left < right));
+        case tokens::Type::kLessEqual:
+            return MakeConstant(Value(left <= right));
+        default:
+            return nullptr;
+    }
+}
+
+expressions::ExprPtr ConstantFolder::FoldLogical(expressions::Logical& expr) {
+    Fold(*expr.left_);
+    Fold(*expr.right_);
+    auto lhs = GetConstant(*expr.left_);
+    if (!lhs.has_value()) {
+        return nullptr;
+    }
+    // The left operand is the result when it decides the outcome, as in AstInterpreter
+    bool decides = expr.op_.GetType() == tokens::Type::kOr ? IsTruthy(*lhs) : !IsTruthy(*lhs);
+    return decides ? expr.left_ : expr.right_;
+}
+
+statements::StmtPtr ConstantFolder::FoldIf(statements::If& stmt) {
+    Fold(*stmt.condition_);
+    Fold(*stmt.then_branch_);
+    if (stmt.else_branch_ != nullptr) {
+        Fold(*stmt.else_branch_);
+    }
+    auto condition = GetConstant(*stmt.condition_);
+    if (!condition.has_value()) {
+        return nullptr;
+    } else if (IsTruthy(*condition)) {
+        return stmt.then_branch_;
+    }
+    return stmt.else_branch_ != nullptr ? stmt.else_branch_ : MakeEmpty(stmt.line_);
+}
+
+expressions::ExprPtr ConstantFolder::MakeConstant(const Value& value) {
+    if (value.Is<double>()) {
+        return expressions::MakeExpr<expressions::Number>(arena_, value.As<double>());
+    } else if (value.Is<bool>()) {
+        return expressions::MakeExpr<expressions::Boolean>(arena_, value.As<bool>());
+    } else if (value.Is<std::string>()) {
+        auto symbol = symbols_.Intern(value.As<std::string>());
+        const auto& constant = constants_.GetString(symbol);
+        return expressions::MakeExpr<expressions::String>(arena_, symbols_.GetName(symbol), constant);
+    }
+    return expressions::MakeExpr<expressions::Nil>(arena_);
+}
+
+statements::StmtPtr ConstantFolder::MakeEmpty(uint32_t line) {
+    return arena_.Make<statements::Stmt>(statements::MakeStmt<statements::Block>(std::span<statements::Stmt>(), line));
+}
+
+std::optional<Value> ConstantFolder::GetConstant(const expressions::Expr& expr) {
+    static constexpr auto kVisitor = [](const auto& arg) -> std::optional<Value> {
+        using T = std::decay_t<decltype(arg)>;
+        if constexpr (std::is_same_v<T, expressions::String>) {
+            return *arg.constant_;
+        } else if constexpr (expressions::IsLiteral<T>) {
+            return Value(arg.value_);
+        } else {
+            return std::nullopt;
+        }
+    };
+
+    return expr.Accept(kVisitor);
+}
+
+bool ConstantFolder::IsEmpty(const statements::Stmt& stmt) {
+    return stmt.Is<statements::Block>() && stmt.As<statements::Block>().statements_.empty();
+}
+
+bool ConstantFolder::IsTruthy(const Value& value) {
+    if (value.Is<std::monostate>()) {
+        return false;
+    } else if (value.Is<bool>()) {
+        return value.As<bool>();
+    }
+    return true;
+}
+
+}  // namespace lox
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <data_structures/arena/arena.hpp>
+#include <data_structures/ast/constant_pool.hpp>
+#include <data_structures/ast/expressions.hpp>
+#include <data_structures/ast/statements.hpp>
+#include <data_structures/ast/value.hpp>
+#include <data_structures/tokens/symbols.hpp>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace lox {
+
+// Evaluates subtrees made of literals ahead of time and drops branches that can't run.
+// Operations that would raise a runtime error, like 1 / 0 or -"x", are left in place
+// so they still fail when and where the program reaches them.
+class ConstantFolder {
+ public:
+    // New nodes are made in `arena`, concatenated strings are interned into `symbols` and `constants`
+    ConstantFolder(Arena& arena, tokens::SymbolTable& symbols, ConstantPool& constants);
+    void Fold(std::vector<statements::Stmt>& statements);
+
+    // Returns the node to replace the visited one with, or nullptr to keep it
+    template <expressions::IsExpression Arg>
+    expressions::ExprPtr operator()(Arg& arg) {
+        if constexpr (expressions::IsLiteral<Arg>) {
+            return nullptr;
+        } else if constexpr (std::is_same_v<Arg, expressions::Grouping>) {
+            Fold(*arg.expr_);
+            return arg.expr_;
+        } else if constexpr (std::is_same_v<Arg, expressions::Unary>) {
+            return FoldUnary(arg);
+        } else if constexpr (std::is_same_v<Arg, expressions::Binary>) {
+            return FoldBinary(arg);
+        } else if constexpr (std::is_same_v<Arg, expressions::Logical>) {
+            return FoldLogical(arg);
+        } else if constexpr (std::is_same_v<Arg, expressions::Conditional>) {
+            Fold(*arg.first_);
+            Fold(*arg.second_);
+            Fold(*arg.third_);
+            if (auto condition = GetConstant(*arg.first_)) {
+                return IsTruthy(*condition) ? arg.second_ : arg.third_;
+            }
+            return nullptr;
+        } else if constexpr (std::is_same_v<Arg, expressions::Variable>) {
+            return nullptr;
+        } else if constexpr (std::is_same_v<Arg, expressions::Assign>) {
+            Fold(*arg.value_);
+            return nullptr;
+        } else {
+            throw std::runtime_error("Unexpected expression type.");
+        }
+    }
+
+    // Returns the statement to replace the visited one with, or nullptr to keep it
+    template <statements::IsStatement Arg>
+    statements::StmtPtr operator()(Arg& arg) {
+        if constexpr (std::is_same_v<Arg, statements::Print>) {
+            Fold(*arg.expr_);
+            return nullptr;
+        } else if constexpr (std::is_same_v<Arg, statements::Expression>) {
+            Fold(*arg.expr_);
+            // Evaluating a literal has no effect
+            return GetConstant(*arg.expr_).has_value() ? MakeEmpty(arg.line_) : nullptr;
+        } else if constexpr (std::is_same_v<Arg, statements::Var>) {
+            if (arg.initializer_ != nullptr) {
+                Fold(*arg.initializer_);
+            }
+            return nullptr;
+        } else if constexpr (std::is_same_v<Arg, statements::Block>) {
+            arg.statements_ = Fold(arg.statements_);
+            return nullptr;
+        } else if constexpr (std::is_same_v<Arg, statements::If>) {
+            return FoldIf(arg);
+        } else if constexpr (std::is_same_v<Arg, statements::While>) {
+            Fold(*arg.condition_);
+            Fold(*arg.statement_);
+            auto condition = GetConstant(*arg.condition_);
+            return condition.has_value() && !IsTruthy(*condition) ? MakeEmpty(arg.line_) : nullptr;
+        } else {
+            throw std::runtime_error("Unexpected statement type.");
+        }
+    }
+
+ private:
+    void Fold(expressions::Expr& expr);
+    void Fold(statements::Stmt& stmt);
+    // Returns the statements left, moved to the front of `statements`
+    std::span<statements::Stmt> Fold(std::span<statements::Stmt> statements);
+    expressions::ExprPtr FoldUnary(expressions::Unary& expr);
+    expressions::ExprPtr FoldBinary(expressions::Binary& expr);
+    expressions::ExprPtr FoldLogical(expressions::Logical& expr);
+    statements::StmtPtr FoldIf(statements::If& stmt);
+
+    expressions::ExprPtr MakeConstant(const Value& value);
+    // Replaces a statement on `line` that does nothing
+    statements::StmtPtr MakeEmpty(uint32_t line);
+
+    static std::optional<Value> GetConstant(const expressions::Expr& expr);
+    static bool IsEmpty(const statements::Stmt& stmt);
+    static bool IsTruthy(const Value& value);
+
+ private:
+    Arena& arena_;
+    tokens::SymbolTable& symbols_;
+    ConstantPool& constants_;
+};
+
+}  // namespace lox
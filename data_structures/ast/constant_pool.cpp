@@ -0,0 +1,22 @@
+#include "constant_pool.hpp"
+
+namespace lox {
+
+ConstantPool::ConstantPool(const tokens::SymbolTable& symbols) : symbols_(symbols) {
+}
+
+const Value& ConstantPool::GetString(tokens::Symbol symbol) {
+    auto index = static_cast<uint32_t>(symbol);
+    if (index >= strings_.size()) {
+        strings_.resize(symbols_.GetSize());
+    }
+    auto& value = strings_[index];
+    if (value.Is<Uninitialized>()) {
+        value = Value(std::string_view(symbols_.GetName(symbol)));
+        // Hashed up front, so comparing two literals can skip their text
+        value.GetHash();
+    }
+    return value;
+}
+
+}  // namespace lox
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <data_structures/ast/value.hpp>
+#include <data_structures/tokens/symbols.hpp>
+#include <deque>
+
+namespace lox {
+
+// String literals of the program, materialized once when they are parsed.
+// Evaluating a literal copies its pooled Value, which never copies the text.
+class ConstantPool {
+ public:
+    explicit ConstantPool(const tokens::SymbolTable& symbols);
+    ConstantPool(const ConstantPool&) = delete;
+    ConstantPool& operator=(const ConstantPool&) = delete;
+
+    // The reference stays valid for the lifetime of the pool
+    const Value& GetString(tokens::Symbol symbol);
+
+ private:
+    const tokens::SymbolTable& symbols_;
+    // Indexed by symbol, entries of identifiers stay uninitialized.
+    // std::deque never moves its elements, so AST nodes can point into it.
+    std::deque<Value> strings_;
+};
+
+}  // namespace lox
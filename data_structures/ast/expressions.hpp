@@ -1,11 +1,19 @@
 #pragma once
 
+#include <cstdint>
+#include <data_structures/arena/arena.hpp>
 #include <data_structures/tokens/tokens.hpp>
 #include <lox/helpers.hpp>
-#include <memory>
-#include <string>
+#include <optional>
+#include <string_view>
 #include <variant>
 
+namespace lox {
+
+class Value;
+
+}  // namespace lox
+
 namespace lox::expressions {
 
 struct String;
@@ -17,12 +25,23 @@ struct Binary;
 struct Grouping;
 class Expr;
 
-using ExprPtr = std::shared_ptr<Expr>;
+// Nodes are owned by the Arena they were made in
+using ExprPtr = Expr*;
+
+// Location of a block-scoped variable computed by Resolver:
+// the number of enclosing blocks to walk up and the index among that block's variables
+struct Slot {
+    uint32_t depth_ = 0;
+    uint32_t index_ = 0;
+};
 
 struct String {
-    explicit String(std::string value);
+    String(std::string_view value, const Value& constant);
 
-    std::string value_;
+    // Points into the SymbolTable
+    std::string_view value_;
+    // Entry of the ConstantPool the literal evaluates to
+    const Value* constant_;
 };
 
 struct Number {
@@ -48,12 +67,33 @@ struct Unary {
     tokens::Token op_;
 };
 
+// Operation a Binary node has rewritten itself into after seeing its operand types
+enum class Specialization : uint8_t {
+    // Not evaluated yet
+    kNone,
+    // An operand didn't match the specialization, stays on the generic path
+    kGeneric,
+    kNumberAdd,
+    kNumberSubtract,
+    kNumberMultiply,
+    kNumberDivide,
+    kNumberGreater,
+    kNumberGreaterEqual,
+    kNumberLess,
+    kNumberLessEqual,
+    kStringConcat,
+    kEqual,
+    kNotEqual,
+};
+
 struct Binary {
     Binary(ExprPtr left, ExprPtr right, tokens::Token&& op);
 
     ExprPtr left_;
     ExprPtr right_;
     tokens::Token op_;
+    // Updated by AstInterpreter while the tree is being run
+    mutable Specialization specialization_ = Specialization::kNone;
 };
 
 struct Conditional {
@@ -74,6 +114,8 @@ struct Variable {
     explicit Variable(const tokens::Token& name);
 
     tokens::Token name_;
+    // std::nullopt for globals
+    std::optional<Slot> slot_;
 };
 
 struct Assign {
@@ -81,6 +123,8 @@ struct Assign {
 
     tokens::Token name_;
     ExprPtr value_;
+    // std::nullopt for globals
+    std::optional<Slot> slot_;
 };
 
 struct Logical {
@@ -108,6 +152,11 @@ class Expr {
         return std::visit(visitor, expr_);
     }
 
+    template <typename V>
+    auto Accept(V& visitor) {
+        return std::visit(visitor, expr_);
+    }
+
     template <IsExpression T>
     const T& As() const {
         return std::get<T>(expr_);
@@ -123,8 +172,8 @@ class Expr {
 };
 
 template <IsExpression T, typename... Args>
-ExprPtr MakeExpr(Args&&... args) {
-    return std::make_shared<Expr>(T(std::forward<Args>(args)...));
+ExprPtr MakeExpr(Arena& arena, Args&&... args) {
+    return arena.Make<Expr>(T(std::forward<Args>(args)...));
 }
 
 }  // namespace lox::expressions
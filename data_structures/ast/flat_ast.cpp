@@ -0,0 +1,172 @@
+#include "flat_ast.hpp"
+
+#include <stdexcept>
+
+namespace lox {
+
+namespace {
+
+class FlatAstBuilder {
+ public:
+    explicit FlatAstBuilder(FlatAst& ast) : ast_(ast) {
+    }
+
+    uint32_t Build(const statements::Stmt& stmt) {
+        return stmt.Accept(*this);
+    }
+
+    uint32_t Build(const expressions::Expr& expr) {
+        return expr.Accept(*this);
+    }
+
+    uint32_t BuildList(std::span<const statements::Stmt> statements) {
+        std::vector<uint32_t> nodes;
+        nodes.reserve(statements.size());
+        for (const auto& statement : statements) {
+            nodes.push_back(Build(statement));
+        }
+        return ast_.AddList(nodes);
+    }
+
+    template <expressions::IsExpression Arg>
+    uint32_t operator()(const Arg& arg) {
+        if constexpr (std::is_same_v<Arg, expressions::String>) {
+            return ast_.AddNode(NodeKind::kConstant, 0, ast_.AddConstant(*arg.constant_));
+        } else if constexpr (expressions::IsLiteral<Arg>) {
+            return ast_.AddNode(NodeKind::kConstant, 0, ast_.AddConstant(Value(arg.value_)));
+        } else if constexpr (std::is_same_v<Arg, expressions::Unary>) {
+            auto kind = arg.op_.GetType() == tokens::Type::kMinus ? NodeKind::kNegate : NodeKind::kNot;
+            return ast_.AddNode(kind, arg.op_.GetLine(), Build(*arg.expr_));
+        } else if constexpr (std::is_same_v<Arg, expressions::Binary>) {
+            auto left = Build(*arg.left_);
+            auto right = Build(*arg.right_);
+            return ast_.AddNode(GetBinaryKind(arg.op_.GetType()), arg.op_.GetLine(), left, right);
+        } else if constexpr (std::is_same_v<Arg, expressions::Logical>) {
+            auto left = Build(*arg.left_);
+            auto right = Build(*arg.right_);
+            auto kind = arg.op_.GetType() == tokens::Type::kOr ? NodeKind::kOr : NodeKind::kAnd;
+            return ast_.AddNode(kind, arg.op_.GetLine(), left, right);
+        } else if constexpr (std::is_same_v<Arg, expressions::Conditional>) {
+            auto condition = Build(*arg.first_);
+            auto then_branch = Build(*arg.second_);
+            auto else_branch = Build(*arg.third_);
+            return ast_.AddNode(NodeKind::kConditional, 0, condition, then_branch, else_branch);
+        } else if constexpr (std::is_same_v<Arg, expressions::Grouping>) {
+            return Build(*arg.expr_);
+        } else if constexpr (std::is_same_v<Arg, expressions::Variable>) {
+            auto symbol = static_cast<uint32_t>(arg.name_.GetSymbol());
+            if (arg.slot_.has_value()) {
+                return ast_.AddNode(NodeKind::kGetLocal, arg.name_.GetLine(), arg.slot_->depth_, arg.slot_->index_,
+                                    symbol);
+            }
+            return ast_.AddNode(NodeKind::kGetGlobal, arg.name_.GetLine(), symbol);
+        } else if constexpr (std::is_same_v<Arg, expressions::Assign>) {
+            auto value = Build(*arg.value_);
+            if (arg.slot_.has_value()) {
+                return ast_.AddNode(NodeKind::kSetLocal, arg.name_.GetLine(), arg.slot_->depth_, arg.slot_->index_,
+                                    value);
+            }
+            return ast_.AddNode(NodeKind::kSetGlobal, arg.name_.GetLine(), static_cast<uint32_t>(arg.name_.GetSymbol()),
+                                value);
+        } else {
+            throw std::runtime_error("Unexpected expression type.");
+        }
+    }
+
+    template <statements::IsStatement Arg>
+    uint32_t operator()(const Arg& arg) {
+        if constexpr (std::is_same_v<Arg, statements::Print>) {
+            return ast_.AddNode(NodeKind::kPrint, 0, Build(*arg.expr_));
+        } else if constexpr (std::is_same_v<Arg, statements::Expression>) {
+            return ast_.AddNode(NodeKind::kExpression, 0, Build(*arg.expr_));
+        } else if constexpr (std::is_same_v<Arg, statements::Var>) {
+            auto initializer = arg.initializer_ != nullptr ? Build(*arg.initializer_) : FlatAst::kNone;
+            if (arg.slot_.has_value()) {
+                return ast_.AddNode(NodeKind::kDefineLocal, arg.name_.GetLine(), *arg.slot_, initializer);
+            }
+            return ast_.AddNode(NodeKind::kDefineGlobal, arg.name_.GetLine(),
+                                static_cast<uint32_t>(arg.name_.GetSymbol()), initializer);
+        } else if constexpr (std::is_same_v<Arg, statements::Block>) {
+            auto first = BuildList(arg.statements_);
+            return ast_.AddNode(NodeKind::kBlock, 0, first, arg.statements_.size(), arg.slots_count_);
+        } else if constexpr (std::is_same_v<Arg, statements::If>) {
+            auto condition = Build(*arg.condition_);
+            auto then_branch = Build(*arg.then_branch_);
+            auto else_branch = arg.else_branch_ != nullptr ? Build(*arg.else_branch_) : FlatAst::kNone;
+            return ast_.AddNode(NodeKind::kIf, 0, condition, then_branch, else_branch);
+        } else if constexpr (std::is_same_v<Arg, statements::While>) {
+            auto condition = Build(*arg.condition_);
+            auto body = Build(*arg.statement_);
+            return ast_.AddNode(NodeKind::kWhile, 0, condition, body);
+        } else {
+            throw std::runtime_error("Unexpected statement type.");
+        }
+    }
+
+ private:
+    static NodeKind GetBinaryKind(tokens::Type type) {
+        switch (type) {
+            case tokens::Type::kPlus:
+                return NodeKind::kAdd;
+            case tokens::Type::kMinus:
+                return NodeKind::kSubtract;
+            case tokens::Type::kStar:
+                return NodeKind::kMultiply;
+            case tokens::Type::kSlash:
+                return NodeKind::kDivide;
+            case tokens::Type::kGreater:
+                return NodeKind::kGreater;
+            case tokens::Type::kGreaterEqual:
+                return NodeKind::kGreaterEqual;
+            case tokens::Type::kLess:
+                return NodeKind::kLess;
+            case tokens::Type::kLessEqual:
+                return NodeKind::kLessEqual;
+            case tokens::Type::kEqualEqual:
+                return NodeKind::kEqual;
+            case tokens::Type::kBangEqual:
+                return NodeKind::kNotEqual;
+            case tokens::Type::kComma:
+                return NodeKind::kComma;
+            default:
+                throw std::runtime_error("Unknown operation.");
+        }
+    }
+
+ private:
+    FlatAst& ast_;
+};
+
+}  // namespace
+
+FlatAst::FlatAst(std::span<const statements::Stmt> statements) {
+    FlatAstBuilder builder(*this);
+    roots_first_ = builder.BuildList(statements);
+    roots_count_ = statements.size();
+}
+
+uint32_t FlatAst::AddNode(NodeKind kind, uint32_t line, uint32_t first, uint32_t second, uint32_t third) {
+    kinds_.push_back(kind);
+    first_.push_back(first);
+    second_.push_back(second);
+    third_.push_back(third);
+    lines_.push_back(line);
+    return kinds_.size() - 1;
+}
+
+uint32_t FlatAst::AddConstant(Value value) {
+    constants_.push_back(std::move(value));
+    return constants_.size() - 1;
+}
+
+uint32_t FlatAst::AddList(std::span<const uint32_t> nodes) {
+    auto first = lists_.size();
+    lists_.insert(lists_.end(), nodes.begin(), nodes.end());
+    return first;
+}
+
+std::span<const uint32_t> FlatAst::GetRoots() const {
+    return GetList(roots_first_, roots_count_);
+}
+
+}  // namespace lox
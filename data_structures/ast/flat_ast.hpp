@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <data_structures/ast/statements.hpp>
+#include <data_structures/ast/value.hpp>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace lox {
+
+// Operands of each kind are listed as (first, second, third)
+enum class NodeKind : uint8_t {
+    kConstant,      // (constant)
+    kNegate,        // (operand)
+    kNot,           // (operand)
+    kAdd,           // (left, right)
+    kSubtract,      // (left, right)
+    kMultiply,      // (left, right)
+    kDivide,        // (left, right)
+    kGreater,       // (left, right)
+    kGreaterEqual,  // (left, right)
+    kLess,          // (left, right)
+    kLessEqual,     // (left, right)
+    kEqual,         // (left, right)
+    kNotEqual,      // (left, right)
+    kComma,         // (left, right)
+    kAnd,           // (left, right)
+    kOr,            // (left, right)
+    kConditional,   // (condition, then, else)
+    kGetGlobal,     // (symbol)
+    kGetLocal,      // (depth, index, symbol)
+    kSetGlobal,     // (symbol, value)
+    kSetLocal,      // (depth, index, value)
+
+    kPrint,         // (expression)
+    kExpression,    // (expression)
+    kDefineGlobal,  // (symbol, initializer or kNone)
+    kDefineLocal,   // (index, initializer or kNone)
+    kBlock,         // (first list entry, statements count, slots count)
+    kIf,            // (condition, then, else or kNone)
+    kWhile,         // (condition, body)
+};
+
+// The program as contiguous arrays of nodes addressed by 32-bit indices, built from the resolved tree.
+// Kinds and operands are what execution touches, lines are only read to report errors.
+class FlatAst {
+ public:
+    static constexpr uint32_t kNone = std::numeric_limits<uint32_t>::max();
+
+    // `statements` must have gone through Resolver
+    explicit FlatAst(std::span<const statements::Stmt> statements);
+
+    uint32_t AddNode(NodeKind kind, uint32_t line, uint32_t first = kNone, uint32_t second = kNone,
+                     uint32_t third = kNone);
+    uint32_t AddConstant(Value value);
+    // Returns the index of the first entry
+    uint32_t AddList(std::span<const uint32_t> nodes);
+
+    NodeKind GetKind(uint32_t node) const {
+        return kinds_[node];
+    }
+
+    uint32_t GetFirst(uint32_t node) const {
+        return first_[node];
+    }
+
+    uint32_t GetSecond(uint32_t node) const {
+        return second_[node];
+    }
+
+    uint32_t GetThird(uint32_t node) const {
+        return third_[node];
+    }
+
+    uint32_t GetLine(uint32_t node) const {
+        return lines_[node];
+    }
+
+    const Value& GetConstant(uint32_t index) const {
+        return constants_[index];
+    }
+
+    std::span<const uint32_t> GetList(uint32_t first, uint32_t count) const {
+        return {lists_.data() + first, count};
+    }
+
+    std::span<const uint32_t> GetRoots() const;
+
+ private:
+    std::vector<NodeKind> kinds_;
+    std::vector<uint32_t> first_;
+    std::vector<uint32_t> second_;
+    std::vector<uint32_t> third_;
+    std::vector<uint32_t> lines_;
+
+    std::vector<Value> constants_;
+    // Statements of blocks, each block's entries are contiguous
+    std::vector<uint32_t> lists_;
+    uint32_t roots_first_ = 0;
+    uint32_t roots_count_ = 0;
+};
+
+}  // namespace lox
@@ -0,0 +1,209 @@
+#include "flat_interpreter.hpp"
+
+#include <lox/errors.hpp>
+#include <lox/lox.hpp>
+
+namespace lox {
+
+FlatInterpreter::FlatInterpreter(Lox& lox)
+    : globals_(lox.GetSymbols()), locals_(lox.GetSymbols()), output_(lox.GetOutput()), lox_(lox) {
+}
+
+void FlatInterpreter::Interpret(const FlatAst& ast) {
+    ast_ = &ast;
+    try {
+        for (auto statement : ast.GetRoots()) {
+            Execute(statement);
+        }
+    } catch (const RuntimeError& error) {
+        lox_.RuntimeError(error);
+    }
+    ast_ = nullptr;
+}
+
+void FlatInterpreter::Execute(uint32_t node) {
+    const auto& ast = *ast_;
+    switch (ast.GetKind(node)) {
+        case NodeKind::kPrint:
+            Evaluate(ast.GetFirst(node)).Print(output_);
+            output_.EndLine();
+            break;
+        case NodeKind::kExpression:
+            Evaluate(ast.GetFirst(node));
+            break;
+        case NodeKind::kDefineGlobal:
+        case NodeKind::kDefineLocal: {
+            Value value;
+            if (ast.GetSecond(node) != FlatAst::kNone) {
+                value = Evaluate(ast.GetSecond(node));
+            }
+            if (ast.GetKind(node) == NodeKind::kDefineLocal) {
+                locals_.Define(ast.GetFirst(node), value);
+            } else {
+                DefineGlobal(node, value);
+            }
+            break;
+        }
+        case NodeKind::kBlock: {
+            ScopeGuard guard(&locals_, ast.GetThird(node));
+            for (auto statement : ast.GetList(ast.GetFirst(node), ast.GetSecond(node))) {
+                Execute(statement);
+            }
+            break;
+        }
+        case NodeKind::kIf:
+            if (IsTruthy(Evaluate(ast.GetFirst(node)))) {
+                Execute(ast.GetSecond(node));
+            } else if (ast.GetThird(node) != FlatAst::kNone) {
+                Execute(ast.GetThird(node));
+            }
+            break;
+        case NodeKind::kWhile:
+            while (IsTruthy(Evaluate(ast.GetFirst(node)))) {
+                Execute(ast.GetSecond(node));
+            }
+            break;
+        default:
+            throw std::runtime_error("Unexpected statement type.");
+    }
+}
+
+Value FlatInterpreter::Evaluate(uint32_t node) {
+    const auto& ast = *ast_;
+    auto kind = ast.GetKind(node);
+    switch (kind) {
+        case NodeKind::kConstant:
+            return ast.GetConstant(ast.GetFirst(node));
+        case NodeKind::kNegate: {
+            auto value = Evaluate(ast.GetFirst(node));
+            if (!value.Is<double>()) {
+                throw RuntimeError(ast.GetLine(node), "Operand must be a number.");
+            }
+            return Value(-value.As<double>());
+        }
+        case NodeKind::kNot:
+            return Value(!IsTruthy(Evaluate(ast.GetFirst(node))));
+        case NodeKind::kAnd:
+        case NodeKind::kOr: {
+            auto lhs = Evaluate(ast.GetFirst(node));
+            if (IsTruthy(lhs) == (kind == NodeKind::kOr)) {
+                return lhs;
+            }
+            return Evaluate(ast.GetSecond(node));
+        }
+        case NodeKind::kConditional:
+            if (IsTruthy(Evaluate(ast.GetFirst(node)))) {
+                return Evaluate(ast.GetSecond(node));
+            }
+            return Evaluate(ast.GetThird(node));
+        case NodeKind::kGetGlobal:
+            return EvaluateGlobal(node);
+        case NodeKind::kGetLocal:
+            return EvaluateLocal(node);
+        case NodeKind::kSetGlobal: {
+            auto value = Evaluate(ast.GetSecond(node));
+            AssignGlobal(node, value);
+            return value;
+        }
+        case NodeKind::kSetLocal: {
+            auto value = Evaluate(ast.GetThird(node));
+            locals_.Assign({ast.GetFirst(node), ast.GetSecond(node)}, value);
+            return value;
+        }
+        default:
+            return EvaluateBinary(kind, node);
+    }
+}
+
+Value FlatInterpreter::EvaluateBinary(NodeKind kind, uint32_t node) {
+    const auto& ast = *ast_;
+    auto lhs = Evaluate(ast.GetFirst(node));
+    auto rhs = Evaluate(ast.GetSecond(node));
+    if (kind == NodeKind::kComma) {
+        return rhs;
+    } else if (kind == NodeKind::kEqual) {
+        return Value(lhs == rhs);
+    } else if (kind == NodeKind::kNotEqual) {
+        return Value(lhs != rhs);
+    } else if (kind == NodeKind::kAdd) {
+        if (lhs.Is<std::string>() && rhs.Is<std::string>()) {
+            return Value::Concatenate(lhs, rhs);
+        } else if (lhs.Is<double>() && rhs.Is<double>()) {
+            return Value(lhs.As<double>() + rhs.As<double>());
+        }
+        throw RuntimeError(ast.GetLine(node), "Operands must be two numbers or two strings.");
+    }
+
+    if (!lhs.Is<double>() || !rhs.Is<double>()) {
+        throw RuntimeError(ast.GetLine(node), "Operands must be numbers.");
+    }
+    auto left = lhs.As<double>();
+    auto right = rhs.As<double>();
+    switch (kind) {
+        case NodeKind::kSubtract:
+            return Value(left - right);
+        case NodeKind::kMultiply:
+            return Value(left * right);
+        case NodeKind::kDivide:
+            if (right == 0) {
+                throw RuntimeError(ast.GetLine(node), "Division by zero.");
+            }
+            return Value(left / right);
+        case NodeKind::kGreater:
+            return Value(left > right);
+        case NodeKind::kGreaterEqual:
+            return Value(left >= right);
+        case NodeKind::kLess:
+            return Value(left < right);
+        case NodeKind::kLessEqual:
+            return Value(left <= right);
+        default:
+            throw std::runtime_error("Unexpected expression type.");
+    }
+}
+
+Value FlatInterpreter::EvaluateGlobal(uint32_t node) {
+    auto name = static_cast<tokens::Symbol>(ast_->GetFirst(node));
+    const auto* value = globals_.Find(name);
+    if (value == nullptr) {
+        throw RuntimeError(ast_->GetLine(node), "Undefined variable '" + lox_.GetSymbols().GetName(name) + "'.");
+    } else if (value->Is<Uninitialized>()) {
+        throw RuntimeError(ast_->GetLine(node),
+                           "Access to uninitialized variable '" + lox_.GetSymbols().GetName(name) + "'.");
+    }
+    return *value;
+}
+
+void FlatInterpreter::DefineGlobal(uint32_t node, const Value& value) {
+    globals_.Define(static_cast<tokens::Symbol>(ast_->GetFirst(node)), value);
+}
+
+void FlatInterpreter::AssignGlobal(uint32_t node, const Value& value) {
+    auto name = static_cast<tokens::Symbol>(ast_->GetFirst(node));
+    auto* variable = globals_.Find(name);
+    if (variable == nullptr) {
+        throw RuntimeError(ast_->GetLine(node), "Undefined variable '" + lox_.GetSymbols().GetName(name) + "'.");
+    }
+    *variable = value;
+}
+
+Value FlatInterpreter::EvaluateLocal(uint32_t node) {
+    const auto& value = locals_.At({ast_->GetFirst(node), ast_->GetSecond(node)});
+    if (value.Is<Uninitialized>()) {
+        auto name = static_cast<tokens::Symbol>(ast_->GetThird(node));
+        throw RuntimeError(ast_->GetLine(node),
+                           "Access to uninitialized variable '" + lox_.GetSymbols().GetName(name) + "'.");
+    }
+    return value;
+}
+
+bool FlatInterpreter::IsTruthy(const Value& value) {
+    if (value.Is<std::monostate>()) {
+        return false;
+    } else if (value.Is<bool>()) {
+        return value.As<bool>();
+    }
+    return true;
+}
+
+}  // namespace lox
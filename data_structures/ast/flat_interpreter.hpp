@@ -0,0 +1,37 @@
+#pragma once
+
+#include <data_structures/ast/flat_ast.hpp>
+#include <data_structures/ast/value.hpp>
+#include <data_structures/environment/environment.hpp>
+#include <lox/output_sink.hpp>
+
+namespace lox {
+
+class Lox;
+
+// Walks a FlatAst by node index, with the same semantics as AstInterpreter
+class FlatInterpreter {
+ public:
+    explicit FlatInterpreter(Lox& lox);
+    void Interpret(const FlatAst& ast);
+
+ private:
+    void Execute(uint32_t node);
+    Value Evaluate(uint32_t node);
+    Value EvaluateBinary(NodeKind kind, uint32_t node);
+    Value EvaluateGlobal(uint32_t node);
+    void DefineGlobal(uint32_t node, const Value& value);
+    void AssignGlobal(uint32_t node, const Value& value);
+    Value EvaluateLocal(uint32_t node);
+
+    static bool IsTruthy(const Value& value);
+
+ private:
+    const FlatAst* ast_ = nullptr;
+    Environment globals_;
+    LocalScopes locals_;
+    OutputSink& output_;
+    Lox& lox_;
+};
+
+}  // namespace lox
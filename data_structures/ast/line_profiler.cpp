@@ -0,0 +1,165 @@
+#include "line_profiler.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <type_traits>
+
+namespace lox {
+
+namespace {
+
+double ToMilliseconds(std::chrono::steady_clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+}  // namespace
+
+LineProfiler::Scope::Scope(LineProfiler& profiler, const statements::Stmt& stmt) : profiler_(profiler) {
+    profiler_.Enter(stmt);
+}
+
+LineProfiler::Scope::~Scope() {
+    profiler_.Exit();
+}
+
+void LineProfiler::Report(std::ostream& out) const {
+    auto write_row = [&out](const Stats& stats) {
+        out << std::setw(12) << stats.count_ << std::setw(16) << ToMilliseconds(stats.inclusive_) << std::setw(16)
+            << ToMilliseconds(stats.exclusive_) << "\n";
+    };
+    auto by_exclusive_time = [](const auto& lhs, const auto& rhs) {
+        return lhs.second->exclusive_ > rhs.second->exclusive_;
+    };
+
+    std::vector<std::pair<uint32_t, const Stats*>> lines;
+    for (uint32_t line = 0; line < lines_.size(); ++line) {
+        if (lines_[line].count_ > 0) {
+            lines.emplace_back(line, &lines_[line]);
+        }
+    }
+    std::stable_sort(lines.begin(), lines.end(), by_exclusive_time);
+    out << std::fixed << std::setprecision(3);
+    out << "Profile by line, sorted by exclusive time\n";
+    out << std::setw(8) << "line" << std::setw(12) << "count" << std::setw(16) << "inclusive ms" << std::setw(16)
+        << "exclusive ms\n";
+    for (const auto& [line, stats] : lines) {
+        out << std::setw(8) << line;
+        write_row(*stats);
+    }
+
+    std::vector<std::pair<Kind, const Stats*>> kinds;
+    for (size_t kind = 0; kind < kKindsCount; ++kind) {
+        if (kinds_[kind].count_ > 0) {
+            kinds.emplace_back(static_cast<Kind>(kind), &kinds_[kind]);
+        }
+    }
+    std::stable_sort(kinds.begin(), kinds.end(), by_exclusive_time);
+    out << "Profile by statement kind, sorted by exclusive time\n";
+    out << std::setw(12) << "kind" << std::setw(12) << "count" << std::setw(16) << "inclusive ms" << std::setw(16)
+        << "exclusive ms\n";
+    for (const auto& [kind, stats] : kinds) {
+        out << std::setw(12) << GetName(kind);
+        write_row(*stats);
+    }
+}
+
+void LineProfiler::WriteCollapsedStacks(std::ostream& out) const {
+    for (uint32_t node = 1; node < stack_nodes_.size(); ++node) {
+        auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(stack_nodes_[node].exclusive_);
+        if (microseconds.count() > 0) {
+            WriteStack(out, node);
+            out << " " << microseconds.count() << "\n";
+        }
+    }
+}
+
+void LineProfiler::Enter(const statements::Stmt& stmt) {
+    auto [line, kind] = Locate(stmt);
+    auto parent = frames_.empty() ? 0 : frames_.back().stack_;
+    frames_.push_back({line, kind, GetStackNode(parent, line, kind), Clock::now()});
+    if (line >= lines_.size()) {
+        lines_.resize(line + 1);
+    }
+    ++lines_[line].active_;
+    ++kinds_[static_cast<size_t>(kind)].active_;
+}
+
+void LineProfiler::Exit() {
+    auto frame = frames_.back();
+    frames_.pop_back();
+    auto elapsed = Clock::now() - frame.start_;
+    auto exclusive = elapsed - frame.nested_;
+    if (!frames_.empty()) {
+        frames_.back().nested_ += elapsed;
+    }
+    stack_nodes_[frame.stack_].exclusive_ += exclusive;
+    for (auto* stats : {&lines_[frame.line_], &kinds_[static_cast<size_t>(frame.kind_)]}) {
+        ++stats->count_;
+        stats->exclusive_ += exclusive;
+        if (--stats->active_ == 0) {
+            stats->inclusive_ += elapsed;
+        }
+    }
+}
+
+uint32_t LineProfiler::GetStackNode(uint32_t parent, uint32_t line, Kind kind) {
+    auto key = (static_cast<uint64_t>(parent) * kKindsCount + static_cast<uint64_t>(kind)) << 32 | line;
+    auto [it, inserted] = stack_children_.try_emplace(key, static_cast<uint32_t>(stack_nodes_.size()));
+    if (inserted) {
+        stack_nodes_.push_back({parent, line, kind});
+    }
+    return it->second;
+}
+
+void LineProfiler::WriteStack(std::ostream& out, uint32_t node) const {
+    const auto& stack_node = stack_nodes_[node];
+    if (stack_node.parent_ != 0) {
+        WriteStack(out, stack_node.parent_);
+        out << ";";
+    }
+    out << GetName(stack_node.kind_) << ":" << stack_node.line_;
+}
+
+std::pair<uint32_t, LineProfiler::Kind> LineProfiler::Locate(const statements::Stmt& stmt) {
+    static constexpr auto kVisitor = [](const auto& arg) -> std::pair<uint32_t, Kind> {
+        using T = std::decay_t<decltype(arg)>;
+        if constexpr (std::is_same_v<T, statements::Expression>) {
+            return {arg.line_, Kind::kExpression};
+        } else if constexpr (std::is_same_v<T, statements::Print>) {
+            return {arg.line_, Kind::kPrint};
+        } else if constexpr (std::is_same_v<T, statements::Var>) {
+            return {arg.name_.GetLine(), Kind::kVar};
+        } else if constexpr (std::is_same_v<T, statements::Block>) {
+            return {arg.line_, Kind::kBlock};
+        } else if constexpr (std::is_same_v<T, statements::If>) {
+            return {arg.line_, Kind::kIf};
+        } else if constexpr (std::is_same_v<T, statements::While>) {
+            return {arg.line_, Kind::kWhile};
+        } else {
+            // Empty statements are dropped by the parser
+            return {0, Kind::kBlock};
+        }
+    };
+
+    return stmt.Accept(kVisitor);
+}
+
+const char* LineProfiler::GetName(Kind kind) {
+    switch (kind) {
+        case Kind::kExpression:
+            return "expression";
+        case Kind::kPrint:
+            return "print";
+        case Kind::kVar:
+            return "var";
+        case Kind::kBlock:
+            return "block";
+        case Kind::kIf:
+            return "if";
+        case Kind::kWhile:
+            return "while";
+    }
+    return "";
+}
+
+}  // namespace lox
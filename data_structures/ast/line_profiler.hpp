@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <data_structures/ast/statements.hpp>
+#include <ostream>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace lox {
+
+// Profiling policy of AstInterpreter that compiles to nothing
+struct NoProfiler {
+    static constexpr bool kEnabled = false;
+};
+
+// Profiling policy of AstInterpreter: counts the executions of statements and their wall time by source line and by
+// statement kind. Inclusive time covers the statements nested in one, exclusive time leaves them out. When a line
+// or a kind is nested in itself, as a block in a block, only the outermost execution adds to its inclusive time.
+class LineProfiler {
+ public:
+    static constexpr bool kEnabled = true;
+
+    // Times a statement for as long as it is alive, also when a runtime error leaves it
+    class Scope {
+     public:
+        Scope(LineProfiler& profiler, const statements::Stmt& stmt);
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        ~Scope();
+
+     private:
+        LineProfiler& profiler_;
+    };
+
+    // Tables by line and by statement kind, sorted by exclusive time
+    void Report(std::ostream& out) const;
+    // A line per nesting of statements with its exclusive time in microseconds, as flamegraph.pl reads them
+    void WriteCollapsedStacks(std::ostream& out) const;
+
+ private:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Kind : uint8_t {
+        kExpression,
+        kPrint,
+        kVar,
+        kBlock,
+        kIf,
+        kWhile,
+    };
+    static constexpr size_t kKindsCount = 6;
+
+    struct Stats {
+        uint64_t count_ = 0;
+        Clock::duration inclusive_{};
+        Clock::duration exclusive_{};
+        // Executions in progress
+        uint32_t active_ = 0;
+    };
+
+    struct Frame {
+        uint32_t line_;
+        Kind kind_;
+        // Node of the nesting that ends with this statement
+        uint32_t stack_;
+        Clock::time_point start_;
+        Clock::duration nested_{};
+    };
+
+    // Nestings of statements form a tree, the root is node 0
+    struct StackNode {
+        uint32_t parent_;
+        uint32_t line_;
+        Kind kind_;
+        Clock::duration exclusive_{};
+    };
+
+ private:
+    void Enter(const statements::Stmt& stmt);
+    void Exit();
+    uint32_t GetStackNode(uint32_t parent, uint32_t line, Kind kind);
+    void WriteStack(std::ostream& out, uint32_t node) const;
+
+    static std::pair<uint32_t, Kind> Locate(const statements::Stmt& stmt);
+    static const char* GetName(Kind kind);
+
+ private:
+    std::vector<Frame> frames_;
+    // Indexed by line
+    std::vector<Stats> lines_;
+    std::array<Stats, kKindsCount> kinds_;
+    std::vector<StackNode> stack_nodes_ = {StackNode{0, 0, Kind::kBlock}};
+    // Child of a node by its parent, kind and line
+    std::unordered_map<uint64_t, uint32_t> stack_children_;
+};
+
+}  // namespace lox
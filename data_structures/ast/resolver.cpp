@@ -0,0 +1,50 @@
+#include "resolver.hpp"
+
+namespace lox {
+
+void Resolver::Resolve(std::span<statements::Stmt> statements) {
+    for (auto& statement : statements) {
+        Resolve(statement);
+    }
+}
+
+void Resolver::Resolve(statements::Stmt& stmt) {
+    stmt.Accept(*this);
+}
+
+void Resolver::Resolve(expressions::Expr& expr) {
+    expr.Accept(*this);
+}
+
+void Resolver::ResolveVar(statements::Var& stmt) {
+    // The initializer is resolved first: it sees the enclosing declaration of the same name
+    if (stmt.initializer_ != nullptr) {
+        Resolve(*stmt.initializer_);
+    }
+    if (scopes_.empty()) {
+        return;
+    }
+
+    auto& scope = scopes_.back();
+    // Redeclaration in the same block reuses the slot
+    stmt.slot_ = scope.try_emplace(stmt.name_.GetSymbol(), scope.size()).first->second;
+}
+
+void Resolver::ResolveBlock(statements::Block& block) {
+    scopes_.emplace_back();
+    Resolve(block.statements_);
+    block.slots_count_ = scopes_.back().size();
+    scopes_.pop_back();
+}
+
+std::optional<expressions::Slot> Resolver::ResolveLocal(tokens::Symbol name) const {
+    for (size_t depth = 0; depth < scopes_.size(); ++depth) {
+        const auto& scope = scopes_[scopes_.size() - 1 - depth];
+        if (auto it = scope.find(name); it != scope.end()) {
+            return expressions::Slot{static_cast<uint32_t>(depth), it->second};
+        }
+    }
+    return std::nullopt;
+}
+
+}  // namespace lox
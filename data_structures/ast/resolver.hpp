@@ -0,0 +1,75 @@
+#pragma once
+
+#include <data_structures/ast/expressions.hpp>
+#include <data_structures/ast/statements.hpp>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace lox {
+
+// Annotates variable declarations, reads and assignments inside blocks with their slots,
+// so that AstInterpreter never looks block-scoped variables up by name.
+// Names not declared in any enclosing block are left unresolved and treated as globals.
+class Resolver {
+ public:
+    void Resolve(std::span<statements::Stmt> statements);
+
+    template <expressions::IsExpression Arg>
+    void operator()(Arg& arg) {
+        if constexpr (expressions::IsLiteral<Arg>) {
+            return;
+        } else if constexpr (std::is_same_v<Arg, expressions::Unary> || std::is_same_v<Arg, expressions::Grouping>) {
+            Resolve(*arg.expr_);
+        } else if constexpr (std::is_same_v<Arg, expressions::Binary> || std::is_same_v<Arg, expressions::Logical>) {
+            Resolve(*arg.left_);
+            Resolve(*arg.right_);
+        } else if constexpr (std::is_same_v<Arg, expressions::Conditional>) {
+            Resolve(*arg.first_);
+            Resolve(*arg.second_);
+            Resolve(*arg.third_);
+        } else if constexpr (std::is_same_v<Arg, expressions::Variable>) {
+            arg.slot_ = ResolveLocal(arg.name_.GetSymbol());
+        } else if constexpr (std::is_same_v<Arg, expressions::Assign>) {
+            Resolve(*arg.value_);
+            arg.slot_ = ResolveLocal(arg.name_.GetSymbol());
+        } else {
+            throw std::runtime_error("Unexpected expression type.");
+        }
+    }
+
+    template <statements::IsStatement Arg>
+    void operator()(Arg& arg) {
+        if constexpr (std::is_same_v<Arg, statements::Print> || std::is_same_v<Arg, statements::Expression>) {
+            Resolve(*arg.expr_);
+        } else if constexpr (std::is_same_v<Arg, statements::Var>) {
+            ResolveVar(arg);
+        } else if constexpr (std::is_same_v<Arg, statements::Block>) {
+            ResolveBlock(arg);
+        } else if constexpr (std::is_same_v<Arg, statements::If>) {
+            Resolve(*arg.condition_);
+            Resolve(*arg.then_branch_);
+            if (arg.else_branch_ != nullptr) {
+                Resolve(*arg.else_branch_);
+            }
+        } else if constexpr (std::is_same_v<Arg, statements::While>) {
+            Resolve(*arg.condition_);
+            Resolve(*arg.statement_);
+        } else {
+            throw std::runtime_error("Unexpected statement type.");
+        }
+    }
+
+ private:
+    void Resolve(statements::Stmt& stmt);
+    void Resolve(expressions::Expr& expr);
+    void ResolveVar(statements::Var& stmt);
+    void ResolveBlock(statements::Block& block);
+    std::optional<expressions::Slot> ResolveLocal(tokens::Symbol name) const;
+
+ private:
+    // Innermost block last, each maps a name to its slot index
+    std::vector<std::unordered_map<tokens::Symbol, uint32_t>> scopes_;
+};
+
+}  // namespace lox
@@ -2,25 +2,28 @@
 
 namespace lox::statements {
 
-Expression::Expression(expressions::ExprPtr expr) : expr_(std::move(expr)) {
+Expression::Expression(expressions::ExprPtr expr, uint32_t line) : expr_(std::move(expr)), line_(line) {
 }
 
-Print::Print(expressions::ExprPtr expr) : expr_(std::move(expr)) {
+Print::Print(expressions::ExprPtr expr, uint32_t line) : expr_(std::move(expr)), line_(line) {
 }
 
 Var::Var(tokens::Token&& name, expressions::ExprPtr initializer)
     : name_(std::move(name)), initializer_(std::move(initializer)) {
 }
 
-Block::Block(std::vector<Stmt>&& statements) : statements_(std::move(statements)) {
+Block::Block(std::span<Stmt> statements, uint32_t line) : statements_(statements), line_(line) {
 }
 
-If::If(expressions::ExprPtr condition, StmtPtr then_branch, StmtPtr else_branch)
-    : condition_(std::move(condition)), then_branch_(std::move(then_branch)), else_branch_(std::move(else_branch)) {
+If::If(expressions::ExprPtr condition, StmtPtr then_branch, StmtPtr else_branch, uint32_t line)
+    : condition_(std::move(condition)),
+      then_branch_(std::move(then_branch)),
+      else_branch_(std::move(else_branch)),
+      line_(line) {
 }
 
-While::While(expressions::ExprPtr condition, lox::statements::StmtPtr statement)
-    : condition_(std::move(condition)), statement_(std::move(statement)) {
+While::While(expressions::ExprPtr condition, lox::statements::StmtPtr statement, uint32_t line)
+    : condition_(std::move(condition)), statement_(std::move(statement)), line_(line) {
 }
 
 }  // namespace lox::statements
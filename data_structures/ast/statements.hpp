@@ -1,26 +1,32 @@
 #pragma once
 
+#include <cstdint>
 #include <data_structures/ast/expressions.hpp>
-#include <memory>
+#include <optional>
+#include <span>
 #include <variant>
-#include <vector>
 
 namespace lox::statements {
 
 class Stmt;
 
-using StmtPtr = std::shared_ptr<Stmt>;
+// Nodes are owned by the Arena they were made in
+using StmtPtr = Stmt*;
 
 struct Expression {
-    explicit Expression(expressions::ExprPtr expr);
+    Expression(expressions::ExprPtr expr, uint32_t line);
 
     expressions::ExprPtr expr_;
+    // Line of the first token
+    uint32_t line_;
 };
 
 struct Print {
-    explicit Print(expressions::ExprPtr expr);
+    Print(expressions::ExprPtr expr, uint32_t line);
 
     expressions::ExprPtr expr_;
+    // Line of the first token
+    uint32_t line_;
 };
 
 struct Var {
@@ -28,27 +34,37 @@ struct Var {
 
     tokens::Token name_;
     expressions::ExprPtr initializer_;
+    // Index among the enclosing block's variables, std::nullopt for globals
+    std::optional<uint32_t> slot_;
 };
 
 struct Block {
-    explicit Block(std::vector<Stmt>&& statements);
+    Block(std::span<Stmt> statements, uint32_t line);
 
-    std::vector<Stmt> statements_;
+    std::span<Stmt> statements_;
+    // Number of distinct variables declared directly in the block
+    uint32_t slots_count_ = 0;
+    // Line of the first token
+    uint32_t line_;
 };
 
 struct If {
-    If(expressions::ExprPtr condition, StmtPtr then_branch, StmtPtr else_branch);
+    If(expressions::ExprPtr condition, StmtPtr then_branch, StmtPtr else_branch, uint32_t line);
 
     expressions::ExprPtr condition_;
     StmtPtr then_branch_;
     StmtPtr else_branch_;
+    // Line of the first token
+    uint32_t line_;
 };
 
 struct While {
-    While(expressions::ExprPtr condition, StmtPtr statement);
+    While(expressions::ExprPtr condition, StmtPtr statement, uint32_t line);
 
     expressions::ExprPtr condition_;
     StmtPtr statement_;
+    // Line of the first token
+    uint32_t line_;
 };
 
 template <typename T>
@@ -67,6 +83,16 @@ class Stmt {
         return std::visit(visitor, stmt_);
     }
 
+    template <typename V>
+    auto Accept(V& visitor) {
+        return std::visit(visitor, stmt_);
+    }
+
+    template <IsStatement T>
+    const T& As() const {
+        return std::get<T>(stmt_);
+    }
+
     template <IsStatement T>
     bool Is() const {
         return std::holds_alternative<T>(stmt_);
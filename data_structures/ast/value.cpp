@@ -1,7 +1,128 @@
 #include "value.hpp"
 
+#include <array>
+#include <cassert>
+#include <lox/numbers.hpp>
+#include <lox/output_sink.hpp>
+#include <utility>
+#include <vector>
+
 namespace lox {
 
+#ifdef LOX_NAN_BOXING
+
+StringObject::StringObject(std::string value) : value_(std::move(value)), length_(value_.size()) {
+}
+
+StringObject::StringObject(StringObject* left, StringObject* right)
+    : left_(left),
+      right_(right),
+      length_(left->length_ + right->length_) {
+}
+
+void StringObject::Flatten() const {
+    // Appending s = s + piece in a loop builds a left-leaning rope as deep as the loop is long
+    std::string text;
+    text.reserve(length_);
+    std::vector<const StringObject*> pending{this};
+    while (!pending.empty()) {
+        const auto* node = pending.back();
+        pending.pop_back();
+        if (node->left_ == nullptr) {
+            text += node->value_;
+        } else {
+            pending.push_back(node->right_);
+            pending.push_back(node->left_);
+        }
+    }
+
+    value_ = std::move(text);
+    auto* left = std::exchange(left_, nullptr);
+    auto* right = std::exchange(right_, nullptr);
+    if (--left->references_ == 0) {
+        Destroy(left);
+    }
+    if (--right->references_ == 0) {
+        Destroy(right);
+    }
+}
+
+void StringObject::Destroy(StringObject* object) {
+    if (object->left_ == nullptr) {
+        delete object;
+        return;
+    }
+
+    std::vector<StringObject*> dead{object};
+    while (!dead.empty()) {
+        auto* node = dead.back();
+        dead.pop_back();
+        for (auto* child : {node->left_, node->right_}) {
+            if (child != nullptr && --child->references_ == 0) {
+                dead.push_back(child);
+            }
+        }
+        delete node;
+    }
+}
+
+Value::Value(std::string value) : Value(new StringObject(std::move(value))) {
+}
+
+Value::Value(StringObject* object) {
+    auto pointer = reinterpret_cast<uintptr_t>(object);
+    assert((pointer & ~kPointerMask) == 0 && "Pointer does not fit in 48 bits");
+    bits_ = kStringMask | pointer;
+}
+
+Value Value::Concatenate(const Value& lhs, const Value& rhs) {
+    auto* left = lhs.GetString();
+    auto* right = rhs.GetString();
+    if (right->length_ == 0) {
+        return lhs;
+    } else if (left->length_ == 0) {
+        return rhs;
+    } else if (left->length_ + right->length_ < kMinRopeLength) {
+        return Value(left->GetText() + right->GetText());
+    }
+    ++left->references_;
+    ++right->references_;
+    return Value(new StringObject(left, right));
+}
+
+bool Value::operator==(const Value& rhs) const {
+    if (Is<double>() && rhs.Is<double>()) {
+        return As<double>() == rhs.As<double>();
+    } else if (Is<std::string>() && rhs.Is<std::string>()) {
+        const auto* left = GetString();
+        const auto* right = rhs.GetString();
+        if (left == right) {
+            return true;
+        } else if (left->length_ != right->length_) {
+            // Lengths are known without flattening a rope
+            return false;
+        } else if (left->hash_ != 0 && right->hash_ != 0 && left->hash_ != right->hash_) {
+            return false;
+        }
+        return left->GetText() == right->GetText();
+    }
+    return bits_ == rhs.bits_;
+}
+
+bool Value::operator!=(const Value& rhs) const {
+    return !(*this == rhs);
+}
+
+void Value::Destroy() const {
+    StringObject::Destroy(GetString());
+}
+
+#else
+
+Value Value::Concatenate(const Value& lhs, const Value& rhs) {
+    return Value(lhs.As<std::string>() + rhs.As<std::string>());
+}
+
 bool Value::operator==(const Value& rhs) const {
     return value_ == rhs.value_;
 }
@@ -10,6 +131,8 @@ bool Value::operator!=(const Value& rhs) const {
     return value_ != rhs.value_;
 }
 
+#endif
+
 std::string Value::Stringify() const {
     static constexpr auto kVisitor = [](const auto& arg) -> std::string {
         using T = std::decay_t<decltype(arg)>;
@@ -20,23 +143,26 @@ std::string Value::Stringify() const {
         } else if constexpr (std::is_same_v<T, bool>) {
             return arg ? "true" : "false";
         } else if constexpr (std::is_same_v<T, double>) {
-            return Value::StringifyDouble(arg);
+            std::array<char, kMaxNumberLength> buffer;
+            return std::string(FormatNumber(arg, buffer));
         } else {
             return {};
         }
     };
 
-    return std::visit(kVisitor, value_);
+    return Accept(kVisitor);
 }
 
-std::string Value::StringifyDouble(double value) {
-    std::string result(std::to_string(value));
-    // Deleting trailing zeroes
-    result.erase(result.find_last_not_of('0') + 1, std::string::npos);
-    if (result.back() == '.') {
-        result.pop_back();
+void Value::Print(OutputSink& out) const {
+    if (Is<double>()) {
+        out.Write(As<double>());
+    } else if (Is<std::string>()) {
+        out.Write(As<std::string>());
+    } else if (Is<bool>()) {
+        out.Write(As<bool>() ? "true" : "false");
+    } else if (Is<std::monostate>()) {
+        out.Write("nil");
     }
-    return result;
 }
 
 }  // namespace lox
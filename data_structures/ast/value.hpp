@@ -1,10 +1,16 @@
 #pragma once
 
+#include <bit>
+#include <cstdint>
+#include <functional>
 #include <string>
+#include <string_view>
 #include <variant>
 
 namespace lox {
 
+class OutputSink;
+
 struct Uninitialized {
     inline bool operator==(Uninitialized) const {
         return true;
@@ -15,6 +21,200 @@ struct Uninitialized {
     }
 };
 
+#ifdef LOX_NAN_BOXING
+
+// Heap-allocated payload of a string Value, shared by all copies of the Value.
+// A concatenation is kept as a rope node over its operands and flattened on first read.
+struct StringObject {
+    explicit StringObject(std::string value);
+    // Takes over one reference to each operand
+    StringObject(StringObject* left, StringObject* right);
+
+    const std::string& GetText() const {
+        if (left_ != nullptr) [[unlikely]] {
+            Flatten();
+        }
+        return value_;
+    }
+
+    size_t GetHash() const {
+        if (hash_ == 0) {
+            hash_ = std::hash<std::string>{}(GetText());
+        }
+        return hash_;
+    }
+
+    // Deletes the object and every rope node only it referenced, without recursion
+    static void Destroy(StringObject* object);
+
+    void Flatten() const;
+
+    mutable std::string value_;
+    mutable StringObject* left_ = nullptr;
+    mutable StringObject* right_ = nullptr;
+    size_t length_ = 0;
+    // Zero until GetHash is first called
+    mutable size_t hash_ = 0;
+    uint32_t references_ = 1;
+};
+
+// 8-byte Value: a double is stored as is, every other type is encoded in the payload of a quiet NaN.
+// Strings set the sign bit and keep a StringObject pointer in the low 48 bits.
+class Value {
+ public:
+    Value() = default;
+    explicit Value(Uninitialized) : bits_(kUninitialized) {
+    }
+
+    explicit Value(std::monostate) : bits_(kNil) {
+    }
+
+    explicit Value(bool value) : bits_(value ? kTrue : kFalse) {
+    }
+
+    explicit Value(double value) : bits_(std::bit_cast<uint64_t>(value)) {
+        if ((bits_ & kQuietNan) == kQuietNan) [[unlikely]] {
+            // A NaN whose payload collides with the tags, hardware never produces those
+            bits_ = kCanonicalNan;
+        }
+    }
+
+    explicit Value(std::string value);
+    explicit Value(std::string_view value) : Value(std::string(value)) {
+    }
+    explicit Value(const char* value) = delete;
+
+    Value(const Value& other) : bits_(other.bits_) {
+        Retain();
+    }
+
+    Value(Value&& other) noexcept : bits_(other.bits_) {
+        other.bits_ = kUninitialized;
+    }
+
+    Value& operator=(const Value& other) {
+        other.Retain();
+        Release();
+        bits_ = other.bits_;
+        return *this;
+    }
+
+    Value& operator=(Value&& other) noexcept {
+        if (this != &other) {
+            Release();
+            bits_ = other.bits_;
+            other.bits_ = kUninitialized;
+        }
+        return *this;
+    }
+
+    ~Value() {
+        Release();
+    }
+
+    template <typename T>
+    decltype(auto) As() const {
+        if constexpr (std::is_same_v<T, double>) {
+            return std::bit_cast<double>(bits_);
+        } else if constexpr (std::is_same_v<T, bool>) {
+            return bits_ == kTrue;
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            return GetString()->GetText();
+        } else if constexpr (std::is_same_v<T, std::monostate>) {
+            return std::monostate{};
+        } else {
+            static_assert(std::is_same_v<T, Uninitialized>, "Unexpected value type.");
+            return Uninitialized{};
+        }
+    }
+
+    template <typename T>
+    bool Is() const {
+        if constexpr (std::is_same_v<T, double>) {
+            return (bits_ & kQuietNan) != kQuietNan;
+        } else if constexpr (std::is_same_v<T, bool>) {
+            return (bits_ | 1) == kTrue;
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            return (bits_ & kStringMask) == kStringMask;
+        } else if constexpr (std::is_same_v<T, std::monostate>) {
+            return bits_ == kNil;
+        } else {
+            static_assert(std::is_same_v<T, Uninitialized>, "Unexpected value type.");
+            return bits_ == kUninitialized;
+        }
+    }
+
+    template <typename V>
+    auto Accept(const V& visitor) const {
+        if (Is<double>()) {
+            return visitor(As<double>());
+        } else if (Is<std::string>()) {
+            return visitor(As<std::string>());
+        } else if (Is<bool>()) {
+            return visitor(As<bool>());
+        } else if (Is<std::monostate>()) {
+            return visitor(std::monostate{});
+        }
+        return visitor(Uninitialized{});
+    }
+
+    // Both values must be strings
+    static Value Concatenate(const Value& lhs, const Value& rhs);
+    // Only for strings, computed once and cached in the shared object
+    size_t GetHash() const {
+        return GetString()->GetHash();
+    }
+
+    std::string Stringify() const;
+    // Same text as Stringify, formatted straight into the sink
+    void Print(OutputSink& out) const;
+    bool operator==(const Value& rhs) const;
+    bool operator!=(const Value& rhs) const;
+
+ private:
+    // Results shorter than this are copied right away instead of becoming a rope node
+    static constexpr size_t kMinRopeLength = 64;
+
+    static constexpr uint64_t kSignBit = 0x8000000000000000;
+    static constexpr uint64_t kQuietNan = 0x7ffc000000000000;
+    static constexpr uint64_t kStringMask = kSignBit | kQuietNan;
+    static constexpr uint64_t kPointerMask = 0x0000ffffffffffff;
+    static constexpr uint64_t kCanonicalNan = 0x7ff8000000000000;
+
+    static constexpr uint64_t kUninitialized = kQuietNan | 1;
+    static constexpr uint64_t kNil = kQuietNan | 2;
+    static constexpr uint64_t kFalse = kQuietNan | 4;
+    static constexpr uint64_t kTrue = kQuietNan | 5;
+
+ private:
+    explicit Value(StringObject* object);
+
+    StringObject* GetString() const {
+        return reinterpret_cast<StringObject*>(bits_ & kPointerMask);
+    }
+
+    void Retain() const {
+        if (Is<std::string>()) {
+            ++GetString()->references_;
+        }
+    }
+
+    void Release() const {
+        if (Is<std::string>() && --GetString()->references_ == 0) {
+            Destroy();
+        }
+    }
+
+    void Destroy() const;
+
+ private:
+    uint64_t bits_ = kUninitialized;
+};
+
+static_assert(sizeof(Value) == sizeof(uint64_t));
+
+#else
+
 class Value {
  public:
     Value() = default;
@@ -23,6 +223,9 @@ class Value {
     explicit Value(T&& value) : value_(std::forward<T>(value)) {
     }
 
+    explicit Value(std::string_view value) : value_(std::string(value)) {
+    }
+
     template <typename T>
     const T& As() const {
         return get<T>(value_);
@@ -38,15 +241,23 @@ class Value {
         return std::visit(visitor, value_);
     }
 
+    // Both values must be strings
+    static Value Concatenate(const Value& lhs, const Value& rhs);
+    // Only for strings
+    size_t GetHash() const {
+        return std::hash<std::string>{}(As<std::string>());
+    }
+
     std::string Stringify() const;
+    // Same text as Stringify, formatted straight into the sink
+    void Print(OutputSink& out) const;
     bool operator==(const Value& rhs) const;
     bool operator!=(const Value& rhs) const;
 
- private:
-    static std::string StringifyDouble(double value);
-
  private:
     std::variant<Uninitialized, std::monostate, bool, double, std::string> value_;
 };
 
+#endif
+
 }  // namespace lox
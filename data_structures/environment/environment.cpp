@@ -1,49 +1,93 @@
 #include "environment.hpp"
 
+#include <cassert>
 #include <lox/errors.hpp>
 
 namespace lox {
 
-Environment::Environment(lox::Environment* enclosing) : enclosing_(enclosing) {
+Environment::Environment(const tokens::SymbolTable& symbols) : symbols_(symbols) {
 }
 
-void Environment::Define(const std::string& name, const lox::Value& value) {
-    values_[name] = value;
+void Environment::Define(tokens::Symbol name, const lox::Value& value) {
+    auto index = static_cast<uint32_t>(name);
+    if (index >= values_.size()) {
+        values_.resize(symbols_.GetSize());
+    }
+    values_[index] = value;
 }
 
 const Value& Environment::Get(const tokens::Token& name) const {
-    auto it = values_.find(name.GetLexeme());
-    if (it == values_.end() && enclosing_ != nullptr) {
-        return enclosing_->Get(name);
-    } else if (it == values_.end()) {
-        throw RuntimeError(name, "Undefined variable '" + name.GetLexeme() + "'.");
-    } else if (it->second.Is<Uninitialized>()) {
-        throw RuntimeError(name, "Access to uninitialized variable '" + name.GetLexeme() + "'.");
+    auto index = static_cast<uint32_t>(name.GetSymbol());
+    if (index >= values_.size() || !values_[index].has_value()) {
+        throw RuntimeError(name, "Undefined variable '" + symbols_.GetName(name.GetSymbol()) + "'.");
+    } else if (values_[index]->Is<Uninitialized>()) {
+        throw RuntimeError(name, "Access to uninitialized variable '" + symbols_.GetName(name.GetSymbol()) + "'.");
     } else {
-        return it->second;
+        return *values_[index];
     }
 }
 
 void Environment::Assign(const tokens::Token& name, const lox::Value& value) {
-    if (values_.contains(name.GetLexeme())) {
-        values_[name.GetLexeme()] = value;
-    } else if (enclosing_ != nullptr) {
-        enclosing_->Assign(name, value);
-    } else {
-        throw RuntimeError(name, "Undefined variable '" + name.GetLexeme() + "'.");
+    auto* variable = Find(name.GetSymbol());
+    if (variable == nullptr) {
+        throw RuntimeError(name, "Undefined variable '" + symbols_.GetName(name.GetSymbol()) + "'.");
+    }
+    *variable = value;
+}
+
+Value* Environment::Find(tokens::Symbol name) {
+    auto index = static_cast<uint32_t>(name);
+    if (index >= values_.size() || !values_[index].has_value()) {
+        return nullptr;
+    }
+    return &*values_[index];
+}
+
+LocalScopes::LocalScopes(const tokens::SymbolTable& symbols) : symbols_(symbols) {
+}
+
+void LocalScopes::Push(uint32_t slots_count) {
+    starts_.push_back(values_.size());
+    values_.resize(values_.size() + slots_count);
+}
+
+void LocalScopes::Pop() {
+    assert(!starts_.empty());
+    values_.resize(starts_.back());
+    starts_.pop_back();
+}
+
+void LocalScopes::Define(uint32_t index, const lox::Value& value) {
+    values_[Offset({0, index})] = value;
+}
+
+const Value& LocalScopes::Get(const tokens::Token& name, expressions::Slot slot) const {
+    const auto& value = values_[Offset(slot)];
+    if (value.Is<Uninitialized>()) {
+        throw RuntimeError(name, "Access to uninitialized variable '" + symbols_.GetName(name.GetSymbol()) + "'.");
     }
+    return value;
+}
+
+void LocalScopes::Assign(expressions::Slot slot, const lox::Value& value) {
+    values_[Offset(slot)] = value;
+}
+
+Value& LocalScopes::At(expressions::Slot slot) {
+    return values_[Offset(slot)];
 }
 
-EnvironmentGuard::EnvironmentGuard(lox::Environment* to_restore)
-    : saved_(std::move(*to_restore)), to_restore_(to_restore) {
+size_t LocalScopes::Offset(expressions::Slot slot) const {
+    assert(slot.depth_ < starts_.size());
+    return starts_[starts_.size() - 1 - slot.depth_] + slot.index_;
 }
 
-EnvironmentGuard::~EnvironmentGuard() {
-    *to_restore_ = std::move(saved_);
+ScopeGuard::ScopeGuard(LocalScopes* scopes, uint32_t slots_count) : scopes_(scopes) {
+    scopes_->Push(slots_count);
 }
 
-Environment* EnvironmentGuard::GetSaved() {
-    return &saved_;
+ScopeGuard::~ScopeGuard() {
+    scopes_->Pop();
 }
 
 }  // namespace lox
@@ -1,34 +1,61 @@
 #pragma once
 
+#include <data_structures/ast/expressions.hpp>
 #include <data_structures/ast/value.hpp>
 #include <data_structures/tokens/tokens.hpp>
+#include <optional>
 #include <string>
-#include <unordered_map>
+#include <vector>
 
 namespace lox {
 
+// Global variables. Looked up by name, so that the REPL can keep adding them between runs.
+// Symbols are dense, so the values are stored in an array indexed by symbol instead of a hash map.
 class Environment {
  public:
-    Environment() = default;
-    explicit Environment(Environment* enclosing);
-    void Define(const std::string& name, const Value& value);
+    // Names for error messages are looked up in `symbols`
+    explicit Environment(const tokens::SymbolTable& symbols);
+    void Define(tokens::Symbol name, const Value& value);
     const Value& Get(const tokens::Token& name) const;
     void Assign(const tokens::Token& name, const Value& value);
+    // Returns nullptr if the variable is not defined
+    Value* Find(tokens::Symbol name);
 
  private:
-    std::unordered_map<std::string, Value> values_;
-    Environment* enclosing_ = nullptr;
+    // std::nullopt marks a symbol that is not a defined variable
+    std::vector<std::optional<Value>> values_;
+    const tokens::SymbolTable& symbols_;
 };
 
-class EnvironmentGuard {
+// Block-scoped variables addressed by the slots computed by Resolver.
+// The slots of all active blocks are kept in one array, innermost block last.
+class LocalScopes {
  public:
-    explicit EnvironmentGuard(Environment* to_restore);
-    ~EnvironmentGuard();
-    Environment* GetSaved();
+    explicit LocalScopes(const tokens::SymbolTable& symbols);
+    void Push(uint32_t slots_count);
+    void Pop();
+    void Define(uint32_t index, const Value& value);
+    const Value& Get(const tokens::Token& name, expressions::Slot slot) const;
+    void Assign(expressions::Slot slot, const Value& value);
+    Value& At(expressions::Slot slot);
 
  private:
-    Environment saved_;
-    Environment* to_restore_ = nullptr;
+    size_t Offset(expressions::Slot slot) const;
+
+ private:
+    std::vector<Value> values_;
+    // Offset of the first slot of each active block
+    std::vector<size_t> starts_;
+    const tokens::SymbolTable& symbols_;
+};
+
+class ScopeGuard {
+ public:
+    ScopeGuard(LocalScopes* scopes, uint32_t slots_count);
+    ~ScopeGuard();
+
+ private:
+    LocalScopes* scopes_ = nullptr;
 };
 
 }  // namespace lox
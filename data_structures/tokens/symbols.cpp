@@ -0,0 +1,66 @@
+#include "symbols.hpp"
+
+#include <array>
+#include <cassert>
+#include <utility>
+
+namespace lox::tokens {
+
+namespace {
+
+// Interned first, in this order, so the symbol of a keyword is its index here
+constexpr std::array<std::pair<std::string_view, Type>, 16> kKeywords = {{
+    {"and", Type::kAnd},        //
+    {"class", Type::kClass},    //
+    {"else", Type::kElse},      //
+    {"false", Type::kFalse},    //
+    {"for", Type::kFor},        //
+    {"fun", Type::kFun},        //
+    {"if", Type::kIf},          //
+    {"nil", Type::kNil},        //
+    {"or", Type::kOr},          //
+    {"print", Type::kPrint},    //
+    {"return", Type::kReturn},  //
+    {"super", Type::kSuper},    //
+    {"this", Type::kThis},      //
+    {"true", Type::kTrue},      //
+    {"var", Type::kVar},        //
+    {"while", Type::kWhile},    //
+}};
+
+}  // namespace
+
+SymbolTable::SymbolTable() {
+    for (const auto& keyword : kKeywords) {
+        Intern(keyword.first);
+    }
+}
+
+Symbol SymbolTable::Intern(std::string_view name) {
+    if (auto it = symbols_.find(name); it != symbols_.end()) {
+        return it->second;
+    }
+    auto symbol = static_cast<Symbol>(names_.size());
+    const auto& stored = names_.emplace_back(name);
+    symbols_.emplace(stored, symbol);
+    return symbol;
+}
+
+const std::string& SymbolTable::GetName(Symbol symbol) const {
+    assert(static_cast<uint32_t>(symbol) < names_.size());
+    return names_[static_cast<uint32_t>(symbol)];
+}
+
+std::optional<Type> SymbolTable::GetKeyword(Symbol symbol) const {
+    auto index = static_cast<uint32_t>(symbol);
+    if (index < kKeywords.size()) {
+        return kKeywords[index].second;
+    }
+    return std::nullopt;
+}
+
+uint32_t SymbolTable::GetSize() const {
+    return names_.size();
+}
+
+}  // namespace lox::tokens
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <data_structures/tokens/type.hpp>
+#include <deque>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace lox::tokens {
+
+// Interned identifier or string literal: equal names have equal symbols
+enum class Symbol : uint32_t {};
+
+// Owns one copy of every interned name. Keywords are interned on construction,
+// so recognizing a keyword is a lookup of the symbol the scanner interns anyway.
+class SymbolTable {
+ public:
+    SymbolTable();
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
+
+    Symbol Intern(std::string_view name);
+    const std::string& GetName(Symbol symbol) const;
+    std::optional<Type> GetKeyword(Symbol symbol) const;
+    // Every symbol is less than the size
+    uint32_t GetSize() const;
+
+ private:
+    // std::deque never moves its elements, so the map can keep views into them
+    std::deque<std::string> names_;
+    std::unordered_map<std::string_view, Symbol> symbols_;
+};
+
+}  // namespace lox::tokens
@@ -1,68 +1,37 @@
 #include "tokens.hpp"
 
-namespace lox::tokens {
-
-std::string Base::ToString() const {
-    std::string buffer = "Type: " + AsString(type_);
-    if (!lexeme_.empty()) {
-        buffer += ", Lexeme: " + lexeme_;
-    }
-    return buffer + ", Line: " + std::to_string(line_);
-}
-
-Base::Base(Type type, std::string&& lexeme, uint32_t line) : lexeme_(std::move(lexeme)), type_(type), line_(line) {
-}
-
-String::String(lox::tokens::Type type, std::string&& lexeme, std::string&& literal, uint32_t line)
-    : LiteralBase(type, std::move(lexeme), std::move(literal), line) {
-}
-
-std::string String::ToString() const {
-    return LiteralBase::ToString() + literal_;
-}
-
-Number::Number(lox::tokens::Type type, std::string&& lexeme, double literal, uint32_t line)
-    : LiteralBase(type, std::move(lexeme), std::move(literal), line) {
-}
-
-std::string Number::ToString() const {
-    return LiteralBase::ToString() + std::to_string(literal_);
-}
+#include <cassert>
+#include <lox/numbers.hpp>
 
-NonLiteral::NonLiteral(lox::tokens::Type type, std::string&& lexeme, uint32_t line)
-    : Base(type, std::move(lexeme), line) {
-}
-
-std::string Token::ToString() const {
-    static constexpr auto kVisitor = [](const auto& arg) -> std::string {
-        return arg.ToString();
-    };
+namespace lox::tokens {
 
-    return std::visit(kVisitor, token_);
+Token::Token(Type type, uint32_t offset, uint32_t length, uint32_t line, Symbol symbol)
+    : offset_(offset), length_(length), type_(type), line_(line), symbol_(symbol) {
+    assert(length <= kMaxLength);
 }
 
-const std::string& Token::GetLexeme() const {
-    static constexpr auto kVisitor = [](const auto& arg) -> const std::string& {
-        return arg.lexeme_;
-    };
-
-    return std::visit(kVisitor, token_);
+std::string Token::ToString(std::string_view source) const {
+    std::string buffer = "Type: " + AsString(type_);
+    if (length_ != 0) {
+        buffer += ", Lexeme: ";
+        buffer += GetLexeme(source);
+    }
+    buffer += ", Line: " + std::to_string(line_);
+    if (type_ == Type::kNumber) {
+        buffer += ", Literal: " + std::to_string(GetNumber(source));
+    } else if (type_ == Type::kString || type_ == Type::kIdentifier) {
+        buffer += ", Literal: #" + std::to_string(static_cast<uint32_t>(symbol_));
+    }
+    return buffer;
 }
 
-Type Token::GetType() const {
-    static constexpr auto kVisitor = [](const auto& arg) -> Type {
-        return arg.type_;
-    };
-
-    return std::visit(kVisitor, token_);
+std::string_view Token::GetLexeme(std::string_view source) const {
+    return source.substr(offset_, length_);
 }
 
-uint32_t Token::GetLine() const {
-    static constexpr auto kVisitor = [](const auto& arg) -> uint32_t {
-        return arg.line_;
-    };
-
-    return std::visit(kVisitor, token_);
+double Token::GetNumber(std::string_view source) const {
+    assert(type_ == Type::kNumber);
+    return ParseNumber(GetLexeme(source));
 }
 
 }  // namespace lox::tokens
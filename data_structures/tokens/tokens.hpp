@@ -1,77 +1,62 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <data_structures/tokens/symbols.hpp>
 #include <data_structures/tokens/type.hpp>
 #include <string>
-#include <variant>
+#include <string_view>
+#include <type_traits>
 
 namespace lox::tokens {
 
-struct Base {
+// One lexeme as a position in the source it was scanned from, which must outlive the token.
+// Identifiers and strings also carry their interned symbol, numbers are decoded on demand.
+class Token {
  public:
-    std::string ToString() const;
+    static constexpr uint32_t kMaxLength = (1u << 24) - 1;
+    // Offsets, including the one of the end of file, must fit in 32 bits
+    static constexpr size_t kMaxSourceLength = UINT32_MAX;
 
- protected:
-    Base(Type type, std::string&& lexeme, uint32_t line);
+    Token() = default;
+    Token(Type type, uint32_t offset, uint32_t length, uint32_t line, Symbol symbol = {});
 
- public:
-    std::string lexeme_;
-    Type type_;
-    uint32_t line_;
-};
+    std::string ToString(std::string_view source) const;
+    std::string_view GetLexeme(std::string_view source) const;
+    // Only for numbers
+    double GetNumber(std::string_view source) const;
 
-template <typename T>
-struct LiteralBase : public Base {
- protected:
-    LiteralBase(Type type, std::string&& lexeme, T&& literal, uint32_t line)
-        : Base(type, std::move(lexeme), line), literal_(std::move(literal)) {
+    Type GetType() const {
+        return type_;
     }
 
-    std::string ToString() const {
-        return Base::ToString() + ", Literal: ";
+    uint32_t GetOffset() const {
+        return offset_;
     }
 
- public:
-    T literal_;
-};
-
-struct String : public LiteralBase<std::string> {
-    String(Type type, std::string&& lexeme, std::string&& literal, uint32_t line);
-    std::string ToString() const;
-};
-
-struct Number : public LiteralBase<double> {
-    Number(Type type, std::string&& lexeme, double literal, uint32_t line);
-    std::string ToString() const;
-};
-
-struct NonLiteral : public Base {
-    NonLiteral(Type type, std::string&& lexeme, uint32_t line);
-};
-
-class Token {
- public:
-    template <typename T>
-    explicit Token(T&& token) : token_(std::forward<T>(token)) {
+    uint32_t GetLength() const {
+        return length_;
     }
 
-    template <typename T>
-    const T& As() const {
-        return get<T>(token_);
+    uint32_t GetLine() const {
+        return line_;
     }
 
-    std::string ToString() const;
-    const std::string& GetLexeme() const;
-    Type GetType() const;
-    uint32_t GetLine() const;
+    // Only for identifiers and strings
+    Symbol GetSymbol() const {
+        return symbol_;
+    }
 
  private:
-    std::variant<NonLiteral, Number, String> token_;
+    uint32_t offset_ = 0;
+    uint32_t length_ : 24 = 0;
+    Type type_ : 8 = Type::kEof;
+    uint32_t line_ = 0;
+    Symbol symbol_{};
 };
 
-template <typename T, typename... Args>
-Token MakeToken(Args&&... args) {
-    return Token(T(std::forward<Args>(args)...));
-}
+static_assert(sizeof(Token) == 16);
+static_assert(std::is_trivially_copyable_v<Token>);
 
 template <typename T>
 concept IsTokenType = std::is_same_v<T, tokens::Type>;
@@ -1,10 +1,11 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 namespace lox::tokens {
 
-enum class Type {
+enum class Type : uint8_t {
     kLeftParen,
     kRightParen,
     kLeftBrace,
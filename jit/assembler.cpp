@@ -0,0 +1,152 @@
+#include "assembler.hpp"
+
+#include <bit>
+#include <cassert>
+#include <cstring>
+
+namespace lox::jit {
+
+Assembler::Label Assembler::NewLabel() {
+    labels_.push_back(kUnbound);
+    return labels_.size() - 1;
+}
+
+void Assembler::Bind(Label label) {
+    assert(labels_[label] == kUnbound);
+    labels_[label] = code_.size();
+}
+
+void Assembler::Jump(Label label) {
+    // jmp rel32
+    Emit({0xe9});
+    EmitJump(label);
+}
+
+void Assembler::JumpIf(Condition condition, Label label) {
+    // jcc rel32
+    Emit({0x0f, static_cast<uint8_t>(0x80 | static_cast<uint8_t>(condition))});
+    EmitJump(label);
+}
+
+void Assembler::Prologue() {
+    // push rbx; push r12; sub rsp, 8; mov rbx, rdi; mov r12, rsi
+    Emit({0x53, 0x41, 0x54, 0x48, 0x83, 0xec, 0x08, 0x48, 0x89, 0xfb, 0x49, 0x89, 0xf4});
+}
+
+void Assembler::Epilogue() {
+    // add rsp, 8; pop r12; pop rbx; ret
+    Emit({0x48, 0x83, 0xc4, 0x08, 0x41, 0x5c, 0x5b, 0xc3});
+}
+
+void Assembler::SetResult(uint32_t value) {
+    // mov eax, imm32
+    Emit({0xb8});
+    Emit32(value);
+}
+
+void Assembler::Load(Xmm dst, uint32_t index) {
+    // movsd dst, [rbx + disp32]
+    EmitSlotAccess(0x10, dst, index);
+}
+
+void Assembler::Store(uint32_t index, Xmm src) {
+    // movsd [rbx + disp32], src
+    EmitSlotAccess(0x11, src, index);
+}
+
+void Assembler::LoadConstant(Xmm dst, double value) {
+    // mov rax, imm64; movq dst, rax
+    Emit({0x48, 0xb8});
+    Emit64(std::bit_cast<uint64_t>(value));
+    Emit({0x66, static_cast<uint8_t>(0x48 | (dst >> 3) << 2), 0x0f, 0x6e, static_cast<uint8_t>(0xc0 | (dst & 7) << 3)});
+}
+
+void Assembler::Move(Xmm dst, Xmm src) {
+    if (dst != src) {
+        // movapd
+        EmitSse(0x66, 0x28, dst, src);
+    }
+}
+
+void Assembler::Zero(Xmm dst) {
+    // xorpd dst, dst
+    EmitSse(0x66, 0x57, dst, dst);
+}
+
+void Assembler::Negate(Xmm dst) {
+    auto rex = static_cast<uint8_t>(0x48 | (dst >> 3) << 2);
+    auto modrm = static_cast<uint8_t>(0xc0 | (dst & 7) << 3);
+    // movq rax, dst; btc rax, 63; movq dst, rax
+    Emit({0x66, rex, 0x0f, 0x7e, modrm});
+    Emit({0x48, 0x0f, 0xba, 0xf8, 0x3f});
+    Emit({0x66, rex, 0x0f, 0x6e, modrm});
+}
+
+void Assembler::Operate(Arithmetic operation, Xmm dst, Xmm src) {
+    EmitSse(0xf2, static_cast<uint8_t>(operation), dst, src);
+}
+
+void Assembler::Compare(Xmm lhs, Xmm rhs) {
+    // ucomisd
+    EmitSse(0x66, 0x2e, lhs, rhs);
+}
+
+void Assembler::Call(const void* function) {
+    // mov rdi, r12; mov rax, imm64; call rax
+    Emit({0x4c, 0x89, 0xe7, 0x48, 0xb8});
+    Emit64(reinterpret_cast<uint64_t>(function));
+    Emit({0xff, 0xd0});
+}
+
+std::vector<uint8_t> Assembler::Finish() {
+    for (auto [offset, label] : jumps_) {
+        assert(labels_[label] != kUnbound);
+        // Relative to the end of the 4-byte operand
+        auto displacement = static_cast<int32_t>(labels_[label] - (offset + 4));
+        std::memcpy(code_.data() + offset, &displacement, sizeof(displacement));
+    }
+    jumps_.clear();
+    return std::move(code_);
+}
+
+void Assembler::EmitSse(uint8_t prefix, uint8_t opcode, Xmm reg, Xmm rm) {
+    code_.push_back(prefix);
+    if (reg >= 8 || rm >= 8) {
+        // REX.R extends the reg field, REX.B the rm field
+        code_.push_back(static_cast<uint8_t>(0x40 | (reg >> 3) << 2 | rm >> 3));
+    }
+    Emit({0x0f, opcode, static_cast<uint8_t>(0xc0 | (reg & 7) << 3 | (rm & 7))});
+}
+
+void Assembler::EmitSlotAccess(uint8_t opcode, Xmm reg, uint32_t index) {
+    code_.push_back(0xf2);
+    if (reg >= 8) {
+        code_.push_back(0x44);
+    }
+    // mod = 10 (disp32), rm = 011 (rbx)
+    Emit({0x0f, opcode, static_cast<uint8_t>(0x83 | (reg & 7) << 3)});
+    Emit32(index * sizeof(double));
+}
+
+void Assembler::EmitJump(Label label) {
+    jumps_.emplace_back(code_.size(), label);
+    Emit32(0);
+}
+
+void Assembler::Emit(std::initializer_list<uint8_t> bytes) {
+    code_.insert(code_.end(), bytes);
+}
+
+void Assembler::Emit32(uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        code_.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+void Assembler::Emit64(uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        code_.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+}  // namespace lox::jit
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+namespace lox::jit {
+
+// Index of an SSE register, xmm0-xmm15
+using Xmm = uint8_t;
+
+// Condition codes of a jcc, named after the flags ucomisd sets.
+// An unordered comparison (a NaN operand) sets parity, zero and carry.
+enum class Condition : uint8_t {
+    kBelow = 0x2,
+    kAboveEqual = 0x3,
+    kEqual = 0x4,
+    kNotEqual = 0x5,
+    kBelowEqual = 0x6,
+    kAbove = 0x7,
+    kParity = 0xa,
+    kNotParity = 0xb,
+};
+
+enum class Arithmetic : uint8_t {
+    kAdd = 0x58,
+    kMultiply = 0x59,
+    kSubtract = 0x5c,
+    kDivide = 0x5e,
+};
+
+// Encodes the few x86-64 instructions the loop compiler emits.
+// Generated code is a function `uint32_t (double* slots, void* context)`:
+// rbx holds `slots`, r12 holds `context` for the helpers it calls.
+class Assembler {
+ public:
+    using Label = uint32_t;
+
+    Label NewLabel();
+    void Bind(Label label);
+    void Jump(Label label);
+    void JumpIf(Condition condition, Label label);
+
+    // Saves rbx and r12 and keeps the stack 16-byte aligned for calls
+    void Prologue();
+    // Returns eax
+    void Epilogue();
+    void SetResult(uint32_t value);
+
+    // movsd between a register and slots[index]
+    void Load(Xmm dst, uint32_t index);
+    void Store(uint32_t index, Xmm src);
+    void LoadConstant(Xmm dst, double value);
+    void Move(Xmm dst, Xmm src);
+    void Zero(Xmm dst);
+    void Negate(Xmm dst);
+    void Operate(Arithmetic operation, Xmm dst, Xmm src);
+    // ucomisd
+    void Compare(Xmm lhs, Xmm rhs);
+    // Calls `function(context, xmm0)`, all xmm registers are clobbered
+    void Call(const void* function);
+
+    // Returns the code with all jumps resolved, every label used must be bound
+    std::vector<uint8_t> Finish();
+
+ private:
+    void EmitSse(uint8_t prefix, uint8_t opcode, Xmm reg, Xmm rm);
+    void EmitSlotAccess(uint8_t opcode, Xmm reg, uint32_t index);
+    void EmitJump(Label label);
+    void Emit(std::initializer_list<uint8_t> bytes);
+    void Emit32(uint32_t value);
+    void Emit64(uint64_t value);
+
+ private:
+    static constexpr size_t kUnbound = SIZE_MAX;
+
+    std::vector<uint8_t> code_;
+    // Offset of each label in the code
+    std::vector<size_t> labels_;
+    // Offset of a rel32 operand and the label it jumps to
+    std::vector<std::pair<size_t, Label>> jumps_;
+};
+
+}  // namespace lox::jit
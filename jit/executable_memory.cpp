@@ -0,0 +1,50 @@
+#include "executable_memory.hpp"
+
+#include <sys/mman.h>
+
+#include <cstring>
+#include <utility>
+
+namespace lox::jit {
+
+std::optional<ExecutableMemory> ExecutableMemory::Make(std::span<const uint8_t> code) {
+    if (code.empty()) {
+        return std::nullopt;
+    }
+
+    void* data = mmap(nullptr, code.size(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (data == MAP_FAILED) {
+        return std::nullopt;
+    }
+    ExecutableMemory memory(data, code.size());
+    std::memcpy(data, code.data(), code.size());
+    if (mprotect(data, code.size(), PROT_READ | PROT_EXEC) != 0) {
+        return std::nullopt;
+    }
+    return memory;
+}
+
+ExecutableMemory::ExecutableMemory(void* data, size_t size) : data_(data), size_(size) {
+}
+
+ExecutableMemory::ExecutableMemory(ExecutableMemory&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)) {
+}
+
+ExecutableMemory& ExecutableMemory::operator=(ExecutableMemory&& other) noexcept {
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    return *this;
+}
+
+ExecutableMemory::~ExecutableMemory() {
+    if (data_ != nullptr) {
+        munmap(data_, size_);
+    }
+}
+
+const void* ExecutableMemory::GetEntry() const {
+    return data_;
+}
+
+}  // namespace lox::jit
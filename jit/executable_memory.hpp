@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+namespace lox::jit {
+
+// Pages holding a copy of generated code. They are filled while writable and then
+// switched to read and execute, so they are never writable and executable at once.
+class ExecutableMemory {
+ public:
+    // Returns std::nullopt if the pages can't be mapped or protected
+    static std::optional<ExecutableMemory> Make(std::span<const uint8_t> code);
+
+    ExecutableMemory(ExecutableMemory&& other) noexcept;
+    ExecutableMemory& operator=(ExecutableMemory&& other) noexcept;
+    ~ExecutableMemory();
+
+    const void* GetEntry() const;
+
+ private:
+    ExecutableMemory(void* data, size_t size);
+
+ private:
+    void* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+}  // namespace lox::jit
@@ -0,0 +1,382 @@
+#include "loop_jit.hpp"
+
+#include <jit/assembler.hpp>
+#include <jit/executable_memory.hpp>
+#include <lox/errors.hpp>
+#include <optional>
+
+namespace lox::jit {
+
+namespace {
+
+#if defined(__x86_64__) && defined(__linux__)
+constexpr bool kNativeCodeSupported = true;
+#else
+constexpr bool kNativeCodeSupported = false;
+#endif
+
+// Holds zero while a division checks its divisor, expressions may use the registers below it
+constexpr Xmm kZero = 15;
+
+// Status the compiled code returns when the loop finished, otherwise it is 1 + the index of the failed division
+constexpr uint32_t kFinished = 0;
+
+using Entry = uint32_t (*)(double* slots, void* context);
+
+void PrintNumber(OutputSink* output, double value) {
+    output->Write(value);
+    output->EndLine();
+}
+
+// A variable declared outside the loop, copied into its native slot on entry and back on exit
+struct Input {
+    // std::nullopt for globals
+    std::optional<expressions::Slot> slot_;
+    tokens::Symbol symbol_{};
+    uint32_t index_ = 0;
+};
+
+}  // namespace
+
+struct CompiledLoop {
+    ExecutableMemory code_;
+    std::vector<Input> inputs_;
+    uint32_t slots_count_ = 0;
+    // Operators of the divisions that check for zero
+    std::vector<tokens::Token> divisions_;
+};
+
+namespace {
+
+class LoopCompiler {
+ public:
+    // Returns nullptr if the loop uses anything the compiler doesn't support
+    std::unique_ptr<CompiledLoop> Compile(const statements::While& loop) {
+        auto exit = assembler_.NewLabel();
+        assembler_.Prologue();
+        exit_ = exit;
+        CompileWhile(loop);
+        assembler_.SetResult(kFinished);
+        assembler_.Bind(exit);
+        assembler_.Epilogue();
+        if (!supported_) {
+            return nullptr;
+        }
+
+        auto code = assembler_.Finish();
+        auto memory = ExecutableMemory::Make(code);
+        if (!memory.has_value()) {
+            return nullptr;
+        }
+        return std::make_unique<CompiledLoop>(
+            CompiledLoop{std::move(*memory), std::move(inputs_), slots_count_, std::move(divisions_)});
+    }
+
+ private:
+    void CompileStatement(const statements::Stmt& stmt) {
+        if (stmt.Is<statements::Expression>()) {
+            CompileNumber(*stmt.As<statements::Expression>().expr_, 0);
+        } else if (stmt.Is<statements::Print>()) {
+            CompileNumber(*stmt.As<statements::Print>().expr_, 0);
+            assembler_.Call(reinterpret_cast<const void*>(&PrintNumber));
+        } else if (stmt.Is<statements::Var>()) {
+            CompileVar(stmt.As<statements::Var>());
+        } else if (stmt.Is<statements::Block>()) {
+            blocks_.emplace_back();
+            for (const auto& statement : stmt.As<statements::Block>().statements_) {
+                CompileStatement(statement);
+            }
+            blocks_.pop_back();
+        } else if (stmt.Is<statements::If>()) {
+            CompileIf(stmt.As<statements::If>());
+        } else if (stmt.Is<statements::While>()) {
+            CompileWhile(stmt.As<statements::While>());
+        } else {
+            supported_ = false;
+        }
+    }
+
+    void CompileVar(const statements::Var& stmt) {
+        // Without an initializer the variable would be uninitialized, which isn't a number
+        if (stmt.initializer_ == nullptr || !stmt.slot_.has_value() || blocks_.empty()) {
+            supported_ = false;
+            return;
+        }
+        // The initializer still sees the previous declaration of the name
+        CompileNumber(*stmt.initializer_, 0);
+        auto [it, inserted] = blocks_.back().try_emplace(*stmt.slot_, slots_count_);
+        if (inserted) {
+            ++slots_count_;
+        }
+        assembler_.Store(it->second, 0);
+    }
+
+    void CompileIf(const statements::If& stmt) {
+        auto otherwise = assembler_.NewLabel();
+        CompileBranch(*stmt.condition_, false, otherwise, 0);
+        CompileStatement(*stmt.then_branch_);
+        if (stmt.else_branch_ == nullptr) {
+            assembler_.Bind(otherwise);
+            return;
+        }
+        auto end = assembler_.NewLabel();
+        assembler_.Jump(end);
+        assembler_.Bind(otherwise);
+        CompileStatement(*stmt.else_branch_);
+        assembler_.Bind(end);
+    }
+
+    void CompileWhile(const statements::While& stmt) {
+        auto start = assembler_.NewLabel();
+        auto end = assembler_.NewLabel();
+        assembler_.Bind(start);
+        CompileBranch(*stmt.condition_, false, end, 0);
+        CompileStatement(*stmt.statement_);
+        assembler_.Jump(start);
+        assembler_.Bind(end);
+    }
+
+    // Leaves the value of a number-typed expression in `dst`, registers above it are clobbered
+    void CompileNumber(const expressions::Expr& expr, Xmm dst) {
+        if (dst + 1 >= kZero) {
+            supported_ = false;
+        } else if (expr.Is<expressions::Number>()) {
+            assembler_.LoadConstant(dst, expr.As<expressions::Number>().value_);
+        } else if (expr.Is<expressions::Grouping>()) {
+            CompileNumber(*expr.As<expressions::Grouping>().expr_, dst);
+        } else if (expr.Is<expressions::Variable>()) {
+            const auto& variable = expr.As<expressions::Variable>();
+            if (auto index = Resolve(variable.name_, variable.slot_)) {
+                assembler_.Load(dst, *index);
+            }
+        } else if (expr.Is<expressions::Assign>()) {
+            const auto& assign = expr.As<expressions::Assign>();
+            CompileNumber(*assign.value_, dst);
+            if (auto index = Resolve(assign.name_, assign.slot_)) {
+                assembler_.Store(*index, dst);
+            }
+        } else if (IsUnary(expr, tokens::Type::kMinus)) {
+            CompileNumber(*expr.As<expressions::Unary>().expr_, dst);
+            assembler_.Negate(dst);
+        } else if (expr.Is<expressions::Binary>()) {
+            CompileArithmetic(expr.As<expressions::Binary>(), dst);
+        } else if (expr.Is<expressions::Conditional>()) {
+            const auto& conditional = expr.As<expressions::Conditional>();
+            auto otherwise = assembler_.NewLabel();
+            auto end = assembler_.NewLabel();
+            CompileBranch(*conditional.first_, false, otherwise, dst);
+            CompileNumber(*conditional.second_, dst);
+            assembler_.Jump(end);
+            assembler_.Bind(otherwise);
+            CompileNumber(*conditional.third_, dst);
+            assembler_.Bind(end);
+        } else {
+            // Strings, booleans, nil, `!` and logical operators don't produce numbers
+            supported_ = false;
+        }
+    }
+
+    void CompileArithmetic(const expressions::Binary& expr, Xmm dst) {
+        std::optional<Arithmetic> operation;
+        switch (expr.op_.GetType()) {
+            case tokens::Type::kPlus:
+                operation = Arithmetic::kAdd;
+                break;
+            case tokens::Type::kMinus:
+                operation = Arithmetic::kSubtract;
+                break;
+            case tokens::Type::kStar:
+                operation = Arithmetic::kMultiply;
+                break;
+            case tokens::Type::kSlash:
+                operation = Arithmetic::kDivide;
+                break;
+            default:
+                // Comparisons produce booleans, they are only compiled as branches
+                supported_ = false;
+                return;
+        }
+
+        CompileNumber(*expr.left_, dst);
+        CompileNumber(*expr.right_, dst + 1);
+        if (operation == Arithmetic::kDivide) {
+            // Same test as the interpreter's rhs == 0, which is false for NaN
+            auto nonzero = assembler_.NewLabel();
+            assembler_.Zero(kZero);
+            assembler_.Compare(dst + 1, kZero);
+            assembler_.JumpIf(Condition::kParity, nonzero);
+            assembler_.JumpIf(Condition::kNotEqual, nonzero);
+            divisions_.push_back(expr.op_);
+            assembler_.SetResult(divisions_.size());
+            assembler_.Jump(exit_);
+            assembler_.Bind(nonzero);
+        }
+        assembler_.Operate(*operation, dst, dst + 1);
+    }
+
+    // Jumps to `target` if the truthiness of the expression is `jump_if`, registers from `base` up are clobbered
+    void CompileBranch(const expressions::Expr& expr, bool jump_if, Assembler::Label target, Xmm base) {
+        if (expr.Is<expressions::Grouping>()) {
+            CompileBranch(*expr.As<expressions::Grouping>().expr_, jump_if, target, base);
+        } else if (expr.Is<expressions::Boolean>() || expr.Is<expressions::Nil>()) {
+            bool truthy = expr.Is<expressions::Boolean>() && expr.As<expressions::Boolean>().value_;
+            if (truthy == jump_if) {
+                assembler_.Jump(target);
+            }
+        } else if (IsUnary(expr, tokens::Type::kBang)) {
+            CompileBranch(*expr.As<expressions::Unary>().expr_, !jump_if, target, base);
+        } else if (expr.Is<expressions::Logical>()) {
+            const auto& logical = expr.As<expressions::Logical>();
+            // `and` is decided by a falsy left operand, `or` by a truthy one
+            bool decides = logical.op_.GetType() == tokens::Type::kOr;
+            if (decides == jump_if) {
+                CompileBranch(*logical.left_, jump_if, target, base);
+                CompileBranch(*logical.right_, jump_if, target, base);
+            } else {
+                auto skip = assembler_.NewLabel();
+                CompileBranch(*logical.left_, decides, skip, base);
+                CompileBranch(*logical.right_, jump_if, target, base);
+                assembler_.Bind(skip);
+            }
+        } else if (expr.Is<expressions::Binary>() && IsComparison(expr.As<expressions::Binary>().op_.GetType())) {
+            CompileComparison(expr.As<expressions::Binary>(), jump_if, target, base);
+        } else {
+            // Any number is truthy, the expression only runs for its side effects
+            CompileNumber(expr, base);
+            if (jump_if) {
+                assembler_.Jump(target);
+            }
+        }
+    }
+
+    void CompileComparison(const expressions::Binary& expr, bool jump_if, Assembler::Label target, Xmm base) {
+        auto lhs = base;
+        auto rhs = static_cast<Xmm>(base + 1);
+        CompileNumber(*expr.left_, lhs);
+        CompileNumber(*expr.right_, rhs);
+
+        auto type = expr.op_.GetType();
+        if (type == tokens::Type::kEqualEqual || type == tokens::Type::kBangEqual) {
+            // Equal means zero set and parity clear, parity is set when either operand is NaN
+            assembler_.Compare(lhs, rhs);
+            if ((type == tokens::Type::kEqualEqual) == jump_if) {
+                auto skip = assembler_.NewLabel();
+                assembler_.JumpIf(Condition::kParity, skip);
+                assembler_.JumpIf(Condition::kEqual, target);
+                assembler_.Bind(skip);
+            } else {
+                assembler_.JumpIf(Condition::kParity, target);
+                assembler_.JumpIf(Condition::kNotEqual, target);
+            }
+            return;
+        }
+
+        // a < b is compared as b > a, so every comparison is false for NaN
+        bool swapped = type == tokens::Type::kLess || type == tokens::Type::kLessEqual;
+        bool strict = type == tokens::Type::kGreater || type == tokens::Type::kLess;
+        assembler_.Compare(swapped ? rhs : lhs, swapped ? lhs : rhs);
+        if (strict) {
+            assembler_.JumpIf(jump_if ? Condition::kAbove : Condition::kBelowEqual, target);
+        } else {
+            assembler_.JumpIf(jump_if ? Condition::kAboveEqual : Condition::kBelow, target);
+        }
+    }
+
+    static bool IsUnary(const expressions::Expr& expr, tokens::Type type) {
+        return expr.Is<expressions::Unary>() && expr.As<expressions::Unary>().op_.GetType() == type;
+    }
+
+    static bool IsComparison(tokens::Type type) {
+        return tokens::IsComparison(type) || type == tokens::Type::kEqualEqual || type == tokens::Type::kBangEqual;
+    }
+
+    // Returns the native slot of a variable, std::nullopt if it is declared inside the loop but not defined yet
+    std::optional<uint32_t> Resolve(const tokens::Token& name, std::optional<expressions::Slot> slot) {
+        if (slot.has_value() && slot->depth_ < blocks_.size()) {
+            const auto& block = blocks_[blocks_.size() - 1 - slot->depth_];
+            if (auto it = block.find(slot->index_); it != block.end()) {
+                return it->second;
+            }
+            supported_ = false;
+            return std::nullopt;
+        }
+
+        if (slot.has_value()) {
+            // Relative to the scope the loop runs in
+            slot->depth_ -= blocks_.size();
+        }
+        for (const auto& input : inputs_) {
+            bool same = slot.has_value()
+                            ? input.slot_.has_value() && input.slot_->depth_ == slot->depth_ &&
+                                  input.slot_->index_ == slot->index_
+                            : !input.slot_.has_value() && input.symbol_ == name.GetSymbol();
+            if (same) {
+                return input.index_;
+            }
+        }
+        inputs_.push_back({slot, name.GetSymbol(), slots_count_});
+        return slots_count_++;
+    }
+
+ private:
+    Assembler assembler_;
+    Assembler::Label exit_ = 0;
+    std::vector<Input> inputs_;
+    // Variables declared in the blocks inside the loop, innermost block last: block slot -> native slot
+    std::vector<std::unordered_map<uint32_t, uint32_t>> blocks_;
+    uint32_t slots_count_ = 0;
+    std::vector<tokens::Token> divisions_;
+    bool supported_ = true;
+};
+
+}  // namespace
+
+LoopJit::LoopJit(Environment& globals, LocalScopes& locals, OutputSink& output)
+    : globals_(globals), locals_(locals), output_(output) {
+}
+
+LoopJit::~LoopJit() = default;
+
+bool LoopJit::Run(const statements::While& loop) {
+    if (!kNativeCodeSupported) {
+        return false;
+    }
+    auto [it, inserted] = loops_.try_emplace(&loop);
+    if (inserted) {
+        it->second = LoopCompiler().Compile(loop);
+    }
+    const auto* compiled = it->second.get();
+    if (compiled == nullptr) {
+        return false;
+    }
+
+    // Entry guard: the code assumes every variable it uses is a number
+    variables_.clear();
+    for (const auto& input : compiled->inputs_) {
+        auto* variable = input.slot_.has_value() ? &locals_.At(*input.slot_) : globals_.Find(input.symbol_);
+        if (variable == nullptr || !variable->Is<double>()) {
+            return false;
+        }
+        variables_.push_back(variable);
+    }
+    slots_.assign(compiled->slots_count_, 0.0);
+    for (size_t i = 0; i < variables_.size(); ++i) {
+        slots_[compiled->inputs_[i].index_] = variables_[i]->As<double>();
+    }
+
+    auto entry = reinterpret_cast<Entry>(const_cast<void*>(compiled->code_.GetEntry()));
+    auto status = entry(slots_.data(), &output_);
+    for (size_t i = 0; i < variables_.size(); ++i) {
+        *variables_[i] = Value(slots_[compiled->inputs_[i].index_]);
+    }
+    if (status != kFinished) {
+        throw RuntimeError(compiled->divisions_[status - 1], "Division by zero.");
+    }
+    return true;
+}
+
+void LoopJit::Clear() {
+    loops_.clear();
+}
+
+}  // namespace lox::jit
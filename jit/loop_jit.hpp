@@ -0,0 +1,42 @@
+#pragma once
+
+#include <data_structures/ast/statements.hpp>
+#include <data_structures/ast/value.hpp>
+#include <data_structures/environment/environment.hpp>
+#include <lox/output_sink.hpp>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace lox::jit {
+
+struct CompiledLoop;
+
+// Compiles `while` loops that only compute with numbers into native SSE2 code, on x86-64 Linux.
+// A loop qualifies if it is made of number literals, arithmetic, comparisons, `and`, `or`, `!`,
+// `?:`, variables, assignments, blocks, `var` with an initializer, `if`, `while` and `print`
+// of numbers. Every variable it uses from outside must hold a number when the loop is entered,
+// otherwise that run of the loop is left to the interpreter.
+class LoopJit {
+ public:
+    LoopJit(Environment& globals, LocalScopes& locals, OutputSink& output);
+    ~LoopJit();
+
+    // Returns false if the interpreter has to run the loop.
+    // Division by zero writes the variables back and throws the interpreter's RuntimeError.
+    bool Run(const statements::While& loop);
+    // Compiled loops are keyed by their nodes, which the next run may reuse
+    void Clear();
+
+ private:
+    Environment& globals_;
+    LocalScopes& locals_;
+    OutputSink& output_;
+    // nullptr for loops that can't be compiled
+    std::unordered_map<const statements::While*, std::unique_ptr<CompiledLoop>> loops_;
+    // Reused between runs: the native variables and where their values came from
+    std::vector<double> slots_;
+    std::vector<Value*> variables_;
+};
+
+}  // namespace lox::jit
@@ -0,0 +1,96 @@
+#include "ast_cache.hpp"
+
+#include <unistd.h>
+
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <data_structures/ast/ast_serializer.hpp>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <lox/mapped_file.hpp>
+
+namespace lox {
+
+namespace {
+
+constexpr std::array<char, 4> kMagic = {'L', 'O', 'X', 'C'};
+
+struct Header {
+    std::array<char, 4> magic_;
+    uint32_t version_;
+    uint64_t source_hash_;
+    uint64_t source_size_;
+    uint64_t payload_size_;
+    uint64_t payload_hash_;
+};
+
+uint64_t Hash(std::string_view data) {
+    return std::hash<std::string_view>{}(data);
+}
+
+}  // namespace
+
+AstCache::AstCache(std::string directory) : directory_(std::move(directory)) {
+}
+
+std::optional<std::vector<statements::Stmt>> AstCache::Load(std::string_view source, Arena& arena,
+                                                            tokens::SymbolTable& symbols,
+                                                            ConstantPool& constants) const {
+    auto source_hash = Hash(source);
+    auto file = MappedFile::Open(GetPath(source_hash));
+    if (!file.has_value()) {
+        return std::nullopt;
+    }
+
+    auto contents = file->GetContents();
+    Header header;
+    if (contents.size() < sizeof(header)) {
+        return std::nullopt;
+    }
+    std::memcpy(&header, contents.data(), sizeof(header));
+    auto payload = contents.substr(sizeof(header));
+    if (header.magic_ != kMagic || header.version_ != kVersion || header.source_hash_ != source_hash ||
+        header.source_size_ != source.size() || header.payload_size_ != payload.size() ||
+        header.payload_hash_ != Hash(payload)) {
+        return std::nullopt;
+    }
+    return DeserializeAst(payload, arena, symbols, constants);
+}
+
+void AstCache::Store(std::string_view source, std::span<const statements::Stmt> statements,
+                     const tokens::SymbolTable& symbols) const {
+    auto payload = SerializeAst(statements, symbols);
+    auto source_hash = Hash(source);
+    Header header{kMagic, kVersion, source_hash, source.size(), payload.size(), Hash(payload)};
+
+    std::error_code error;
+    std::filesystem::create_directories(directory_, error);
+    auto path = GetPath(source_hash);
+    // Written aside and renamed, so a concurrent run never maps a partial file
+    auto temporary = path + "." + std::to_string(getpid()) + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+        if (!file.good()) {
+            std::filesystem::remove(temporary, error);
+            return;
+        }
+    }
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+    }
+}
+
+std::string AstCache::GetPath(uint64_t source_hash) const {
+    std::array<char, 16> digits;
+    auto end = std::to_chars(digits.data(), digits.data() + digits.size(), source_hash, 16).ptr;
+    std::string name(digits.data(), end);
+    name.insert(0, digits.size() - name.size(), '0');
+    return directory_ + "/" + name + "-v" + std::to_string(kVersion) + ".loxc";
+}
+
+}  // namespace lox
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <data_structures/arena/arena.hpp>
+#include <data_structures/ast/constant_pool.hpp>
+#include <data_structures/ast/statements.hpp>
+#include <data_structures/tokens/symbols.hpp>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lox {
+
+// Parsed programs saved as .loxc files in a directory, named after the hash of their source and the format version.
+// An entry is only used if its header matches the source and its contents pass a checksum.
+class AstCache {
+ public:
+    // Bump whenever the encoding of the tree or its tokens changes
+    static constexpr uint32_t kVersion = 2;
+
+    explicit AstCache(std::string directory);
+
+    // Returns std::nullopt if there is no usable entry for `source`
+    std::optional<std::vector<statements::Stmt>> Load(std::string_view source, Arena& arena,
+                                                      tokens::SymbolTable& symbols, ConstantPool& constants) const;
+    // Failures are ignored, the next run just parses again
+    void Store(std::string_view source, std::span<const statements::Stmt> statements,
+               const tokens::SymbolTable& symbols) const;
+
+ private:
+    std::string GetPath(uint64_t source_hash) const;
+
+ private:
+    std::string directory_;
+};
+
+}  // namespace lox
@@ -3,7 +3,10 @@
 namespace lox {
 
 RuntimeError::RuntimeError(const tokens::Token& token, std::string&& message)
-    : std::runtime_error(std::move(message)), token_(token) {
+    : RuntimeError(token.GetLine(), std::move(message)) {
+}
+
+RuntimeError::RuntimeError(uint32_t line, std::string&& message) : std::runtime_error(std::move(message)), line_(line) {
 }
 
 }  // namespace lox
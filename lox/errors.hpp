@@ -7,8 +7,9 @@ namespace lox {
 
 struct RuntimeError : public std::runtime_error {
     RuntimeError(const tokens::Token& token, std::string&& message);
+    RuntimeError(uint32_t line, std::string&& message);
 
-    tokens::Token token_;
+    uint32_t line_ = 0;
 };
 
 struct ParseError : public std::runtime_error {
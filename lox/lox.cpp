@@ -1,39 +1,82 @@
 #include "lox.hpp"
 
 #include <sysexits.h>
+#include <unistd.h>
 
 #include <data_structures/ast/ast_printer.hpp>
+#include <data_structures/ast/code_emitter.hpp>
+#include <data_structures/ast/constant_folder.hpp>
+#include <data_structures/ast/resolver.hpp>
 #include <fstream>
 #include <iostream>
 #include <lox/errors.hpp>
+#include <lox/mapped_file.hpp>
+#include <parser/parallel_parser.hpp>
 #include <parser/parser.hpp>
 #include <scanner/scanner.hpp>
 
 namespace lox {
 
-Lox::Lox() : interpreter_(*this) {
+namespace {
+
+FlushPolicy GetFlushPolicy(const Options& options) {
+    if (options.flush_.has_value()) {
+        return *options.flush_;
+    }
+    return isatty(STDOUT_FILENO) ? FlushPolicy::kLine : FlushPolicy::kBlock;
+}
+
+}  // namespace
+
+Lox::Lox(Options options)
+    : options_(std::move(options)),
+      constants_(symbols_),
+      cache_(options_.cache_),
+      output_(GetFlushPolicy(options_)),
+      interpreter_(*this, options_.jit_),
+      flat_interpreter_(*this),
+      closure_interpreter_(*this),
+      vm_(*this) {
+    auto threads = options_.threads_ != 0 ? options_.threads_ : std::thread::hardware_concurrency();
+    if (threads > 1) {
+        pool_.emplace(threads);
+    }
+    if (options_.profile_) {
+        profiling_interpreter_.emplace(*this, options_.jit_);
+    }
 }
 
-void Lox::RunFile(const std::string& filename) {
-    std::ifstream file_stream(filename);
-    std::string source{std::istreambuf_iterator<char>(file_stream), std::istreambuf_iterator<char>()};
-    Run(std::move(source));
+int Lox::RunFile(const std::string& filename) {
+    if (auto file = MappedFile::Open(filename)) {
+        Run(file->GetContents());
+    } else {
+        // Pipes and other files that can't be mapped are read into memory
+        std::ifstream file_stream(filename);
+        std::string source{std::istreambuf_iterator<char>(file_stream), std::istreambuf_iterator<char>()};
+        Run(source);
+    }
+    ReportProfile();
     if (had_error_) {
-        std::exit(EX_DATAERR);
+        return EX_DATAERR;
     } else if (had_runtime_error_) {
-        std::exit(EX_SOFTWARE);
+        return EX_SOFTWARE;
     }
+    return EX_OK;
 }
 
 void Lox::RunPrompt() {
+    // Lines typed at the prompt aren't worth caching
+    cache_.reset();
     while (!std::cin.eof()) {
-        std::cout << "> ";
+        output_.Write("> ");
+        output_.Flush();
         std::string line;
         std::getline(std::cin, line);
-        Run(std::move(line));
+        Run(line);
         had_error_ = false;
         had_runtime_error_ = false;
     }
+    ReportProfile();
 }
 
 void Lox::Error(int line, const std::string& message) {
@@ -44,28 +87,133 @@ void Lox::Error(const tokens::Token& token, const std::string& message) {
     if (token.GetType() == tokens::Type::kEof) {
         Report(token.GetLine(), " at end", message);
     } else {
-        Report(token.GetLine(), " at '" + token.GetLexeme() + "'", message);
+        Report(token.GetLine(), " at '" + std::string(token.GetLexeme(source_)) + "'", message);
     }
 }
 
 void Lox::RuntimeError(const lox::RuntimeError& error) {
-    std::cerr << "[line " << error.token_.GetLine() << "] " << error.what() << "\n";
+    // Keep the output printed before the error ahead of it
+    output_.Flush();
+    std::cerr << "[line " << error.line_ << "] " << error.what() << "\n";
     had_runtime_error_ = true;
 }
 
-void Lox::Run(std::string&& source) {
-    Scanner scanner(std::move(source), *this);
-    Parser parser(scanner.ScanTokens(), *this);
-    auto statements = parser.Parse();
-    if (statements.empty() || had_error_) {
+tokens::SymbolTable& Lox::GetSymbols() {
+    return symbols_;
+}
+
+ConstantPool& Lox::GetConstants() {
+    return constants_;
+}
+
+OutputSink& Lox::GetOutput() {
+    return output_;
+}
+
+void Lox::Run(std::string_view source) {
+    if (source.length() > tokens::Token::kMaxSourceLength) {
+        Error(1, "Source is too long.");
         return;
     }
-    interpreter_.Interpret(statements);
+    source_ = source;
+    RunSource();
+    source_ = {};
+    if (output_.GetPolicy() != FlushPolicy::kExit) {
+        output_.Flush();
+    }
+}
+
+void Lox::RunSource() {
+    if (options_.engine_ == Engine::kFlat && !options_.dump_ast_ && !options_.emit_c_) {
+        if (auto ast = Flatten()) {
+            flat_interpreter_.Interpret(*ast);
+        }
+        return;
+    }
+    Arena arena;
+    auto statements = Parse(arena);
+    if (statements.empty()) {
+        return;
+    }
+    if (options_.dump_ast_) {
+        output_.Write(AstPrinter(symbols_).Print(statements));
+    } else if (options_.emit_c_) {
+        Resolver resolver;
+        resolver.Resolve(statements);
+        output_.Write(CodeEmitter(symbols_).Emit(statements));
+    } else if (options_.engine_ == Engine::kVm) {
+        vm_.Interpret(statements);
+    } else {
+        Resolver resolver;
+        resolver.Resolve(statements);
+        if (options_.engine_ == Engine::kClosure) {
+            closure_interpreter_.Interpret(statements);
+        } else if (profiling_interpreter_.has_value()) {
+            profiling_interpreter_->Interpret(statements);
+        } else {
+            interpreter_.Interpret(statements);
+        }
+    }
+}
+
+std::vector<statements::Stmt> Lox::Parse(Arena& arena) {
+    std::vector<statements::Stmt> statements;
+    if (auto cached = cache_.has_value() ? cache_->Load(source_, arena, symbols_, constants_) : std::nullopt) {
+        statements = std::move(*cached);
+    } else {
+        Scanner scanner(source_, *this, pool_.has_value() ? &*pool_ : nullptr);
+        if (const auto* scanned = scanner.GetScanned()) {
+            // A source large enough to be scanned in parallel is parsed in parallel too
+            statements = ParallelParser(*scanned, source_, arena, *this, *pool_).Parse();
+        } else {
+            Parser parser(scanner, source_, arena, *this);
+            statements = parser.Parse();
+        }
+        if (had_error_) {
+            return {};
+        }
+        if (cache_.has_value()) {
+            cache_->Store(source_, statements, symbols_);
+        }
+    }
+    if (options_.optimize_) {
+        ConstantFolder folder(arena, symbols_, constants_);
+        folder.Fold(statements);
+    }
+    return statements;
+}
+
+std::optional<FlatAst> Lox::Flatten() {
+    Arena arena;
+    auto statements = Parse(arena);
+    if (statements.empty()) {
+        return std::nullopt;
+    }
+    Resolver resolver;
+    resolver.Resolve(statements);
+    return FlatAst(statements);
 }
 
 void Lox::Report(int line, const std::string& where, const std::string& message) {
+    output_.Flush();
     std::cerr << "[line " << line << "] Error " << where << ": " << message << "\n";
     had_error_ = true;
 }
 
+void Lox::ReportProfile() {
+    if (!profiling_interpreter_.has_value()) {
+        return;
+    }
+    output_.Flush();
+    const auto& profiler = profiling_interpreter_->GetProfiler();
+    profiler.Report(std::cerr);
+    if (options_.profile_stacks_.has_value()) {
+        std::ofstream stacks(*options_.profile_stacks_);
+        profiler.WriteCollapsedStacks(stacks);
+        if (!stacks) {
+            std::cerr << "Could not write the profile to " << *options_.profile_stacks_ << "\n";
+        }
+    }
+}
+
 }  // namespace lox
@@ -1,8 +1,20 @@
 #pragma once
 
+#include <data_structures/arena/arena.hpp>
 #include <data_structures/ast/ast_interpreter.hpp>
+#include <data_structures/ast/closure_interpreter.hpp>
+#include <data_structures/ast/constant_pool.hpp>
+#include <data_structures/ast/flat_interpreter.hpp>
 #include <data_structures/tokens/tokens.hpp>
+#include <lox/ast_cache.hpp>
+#include <lox/options.hpp>
+#include <lox/output_sink.hpp>
+#include <lox/thread_pool.hpp>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
+#include <vm/vm.hpp>
 
 namespace lox {
 
@@ -10,19 +22,45 @@ struct RuntimeError;
 
 class Lox {
  public:
-    Lox();
-    void RunFile(const std::string& filename);
+    explicit Lox(Options options = {});
+    // Returns the process exit code
+    int RunFile(const std::string& filename);
     void RunPrompt();
     void Error(int line, const std::string& message);
     void Error(const tokens::Token& token, const std::string& message);
     void RuntimeError(const RuntimeError& error);
+    tokens::SymbolTable& GetSymbols();
+    ConstantPool& GetConstants();
+    OutputSink& GetOutput();
 
  private:
-    void Run(std::string&& source);
+    // `source` must stay alive until the run finishes
+    void Run(std::string_view source);
+    void RunSource();
+    // Returns no statements if there were syntax errors, a cached tree skips scanning and parsing
+    std::vector<statements::Stmt> Parse(Arena& arena);
+    // Parses and resolves into a FlatAst, so the tree and its tokens are released before execution
+    std::optional<FlatAst> Flatten();
     void Report(int line, const std::string& where, const std::string& message);
+    // Writes the profile of the tree walker, if it was asked for
+    void ReportProfile();
 
  private:
+    Options options_;
+    tokens::SymbolTable symbols_;
+    ConstantPool constants_;
+    std::optional<AstCache> cache_;
+    // Only with more than one thread
+    std::optional<ThreadPool> pool_;
+    OutputSink output_;
     AstInterpreter interpreter_;
+    // Replaces interpreter_ with --profile
+    std::optional<ProfilingAstInterpreter> profiling_interpreter_;
+    FlatInterpreter flat_interpreter_;
+    ClosureInterpreter closure_interpreter_;
+    vm::VirtualMachine vm_;
+    // Source of the current run, tokens refer into it
+    std::string_view source_;
     bool had_error_ = false;
     bool had_runtime_error_ = false;
 };
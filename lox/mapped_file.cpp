@@ -0,0 +1,64 @@
+#include "mapped_file.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <utility>
+
+namespace lox {
+
+std::optional<MappedFile> MappedFile::Open(const std::string& filename) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+
+    struct stat info {};
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        close(fd);
+        return std::nullopt;
+    }
+    auto size = static_cast<size_t>(info.st_size);
+    if (size == 0) {
+        // Zero-length mappings are not allowed
+        close(fd);
+        return MappedFile(nullptr, 0);
+    }
+
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps its own reference to the file
+    close(fd);
+    if (data == MAP_FAILED) {
+        return std::nullopt;
+    }
+    // The scanner reads the source front to back exactly once
+    madvise(data, size, MADV_SEQUENTIAL);
+    return MappedFile(static_cast<const char*>(data), size);
+}
+
+MappedFile::MappedFile(const char* data, size_t size) : data_(data), size_(size) {
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)) {
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    return *this;
+}
+
+MappedFile::~MappedFile() {
+    if (data_ != nullptr) {
+        munmap(const_cast<char*>(data_), size_);
+    }
+}
+
+std::string_view MappedFile::GetContents() const {
+    return {data_, size_};
+}
+
+}  // namespace lox
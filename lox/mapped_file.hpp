@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace lox {
+
+// Read-only memory mapping of a whole file, unmapped on destruction
+class MappedFile {
+ public:
+    // Returns std::nullopt if the file can't be mapped, e.g. it doesn't exist or is a pipe
+    static std::optional<MappedFile> Open(const std::string& filename);
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    ~MappedFile();
+
+    std::string_view GetContents() const;
+
+ private:
+    MappedFile(const char* data, size_t size);
+
+ private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+}  // namespace lox
@@ -0,0 +1,35 @@
+#include "numbers.hpp"
+
+#include <cassert>
+#include <charconv>
+#include <cmath>
+#include <limits>
+
+namespace lox {
+
+double ParseNumber(std::string_view literal) {
+    double value = 0.0;
+    [[maybe_unused]] auto [end, error] = std::from_chars(literal.data(), literal.data() + literal.size(), value);
+    if (error == std::errc::result_out_of_range) {
+        // from_chars leaves `value` alone, round as strtod does: a nonzero integer part overflows, else it underflows
+        auto integer_part = literal.substr(0, literal.find('.'));
+        auto overflows = integer_part.find_first_not_of('0') != std::string_view::npos;
+        return overflows ? std::numeric_limits<double>::infinity() : 0.0;
+    }
+    assert(error == std::errc() && end == literal.data() + literal.size());
+    return value;
+}
+
+std::string_view FormatNumber(double value, std::span<char, kMaxNumberLength> buffer) {
+    static constexpr double kMinFixed = 1e-7;
+    static constexpr double kMaxFixed = 1e21;
+
+    auto magnitude = std::fabs(value);
+    auto format = magnitude == 0 || (magnitude >= kMinFixed && magnitude < kMaxFixed) ? std::chars_format::fixed
+                                                                                       : std::chars_format::scientific;
+    [[maybe_unused]] auto [end, error] = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value, format);
+    assert(error == std::errc());
+    return {buffer.data(), static_cast<size_t>(end - buffer.data())};
+}
+
+}  // namespace lox
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string_view>
+
+namespace lox {
+
+// Enough for every double formatted by FormatNumber
+inline constexpr size_t kMaxNumberLength = 32;
+
+// Parses a number literal as the scanner accepts it: digits with an optional fraction
+double ParseNumber(std::string_view literal);
+
+// Writes the shortest text that reads back as `value` and returns the written part of `buffer`.
+// Numbers from 1e-7 up to 1e21 are written without an exponent, so integers print as integers.
+std::string_view FormatNumber(double value, std::span<char, kMaxNumberLength> buffer);
+
+}  // namespace lox
@@ -0,0 +1,101 @@
+#include "options.hpp"
+
+#include <charconv>
+#include <string_view>
+
+namespace lox {
+
+namespace {
+
+std::optional<Engine> ParseEngine(std::string_view name) {
+    if (name == "ast") {
+        return Engine::kAst;
+    } else if (name == "vm") {
+        return Engine::kVm;
+    } else if (name == "flat") {
+        return Engine::kFlat;
+    } else if (name == "closure") {
+        return Engine::kClosure;
+    }
+    return std::nullopt;
+}
+
+std::optional<FlushPolicy> ParseFlushPolicy(std::string_view name) {
+    if (name == "line") {
+        return FlushPolicy::kLine;
+    } else if (name == "block") {
+        return FlushPolicy::kBlock;
+    } else if (name == "exit") {
+        return FlushPolicy::kExit;
+    }
+    return std::nullopt;
+}
+
+std::optional<uint32_t> ParseThreadsCount(std::string_view text) {
+    uint32_t count = 0;
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), count);
+    if (error != std::errc() || end != text.data() + text.size()) {
+        return std::nullopt;
+    }
+    return count;
+}
+
+}  // namespace
+
+std::optional<Options> ParseOptions(int argc, char** argv) {
+    static constexpr std::string_view kEnginePrefix = "--engine=";
+    static constexpr std::string_view kFlushPrefix = "--flush=";
+    static constexpr std::string_view kCachePrefix = "--cache=";
+    static constexpr std::string_view kThreadsPrefix = "--threads=";
+    static constexpr std::string_view kProfilePrefix = "--profile=";
+
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg.starts_with(kEnginePrefix)) {
+            auto engine = ParseEngine(arg.substr(kEnginePrefix.size()));
+            if (!engine.has_value()) {
+                return std::nullopt;
+            }
+            options.engine_ = *engine;
+        } else if (arg.starts_with(kFlushPrefix)) {
+            auto flush = ParseFlushPolicy(arg.substr(kFlushPrefix.size()));
+            if (!flush.has_value()) {
+                return std::nullopt;
+            }
+            options.flush_ = *flush;
+        } else if (arg.starts_with(kCachePrefix) && arg.size() > kCachePrefix.size()) {
+            options.cache_ = std::string(arg.substr(kCachePrefix.size()));
+        } else if (arg.starts_with(kThreadsPrefix)) {
+            auto threads = ParseThreadsCount(arg.substr(kThreadsPrefix.size()));
+            if (!threads.has_value()) {
+                return std::nullopt;
+            }
+            options.threads_ = *threads;
+        } else if (arg == "--profile") {
+            options.profile_ = true;
+        } else if (arg.starts_with(kProfilePrefix) && arg.size() > kProfilePrefix.size()) {
+            options.profile_ = true;
+            options.profile_stacks_ = std::string(arg.substr(kProfilePrefix.size()));
+        } else if (arg == "-O0" || arg == "-O1") {
+            options.optimize_ = arg == "-O1";
+        } else if (arg == "--dump-ast") {
+            options.dump_ast_ = true;
+        } else if (arg == "--emit-c") {
+            options.emit_c_ = true;
+        } else if (arg == "--jit") {
+            options.jit_ = true;
+        } else if (arg.starts_with("-") || options.script_.has_value()) {
+            return std::nullopt;
+        } else {
+            options.script_ = std::string(arg);
+        }
+    }
+    if (options.profile_ && (options.engine_ != Engine::kAst || options.dump_ast_ || options.emit_c_)) {
+        // Only the tree walker is instrumented, other engines would silently produce no profile
+        return std::nullopt;
+    }
+    return options;
+}
+
+}  // namespace lox
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <optional>
+#include <string>
+
+namespace lox {
+
+enum class Engine {
+    kAst,
+    kVm,
+    kFlat,
+    kClosure,
+};
+
+enum class FlushPolicy {
+    // After every printed line
+    kLine,
+    // When the buffer fills up
+    kBlock,
+    // Only when the program exits or reports an error
+    kExit,
+};
+
+struct Options {
+    Engine engine_ = Engine::kAst;
+    // std::nullopt flushes every line to a terminal and blocks otherwise
+    std::optional<FlushPolicy> flush_;
+    // Constant folding, disabled with -O0
+    bool optimize_ = true;
+    // Print the tree after optimization instead of running it
+    bool dump_ast_ = false;
+    // Print the program translated to C++ instead of running it
+    bool emit_c_ = false;
+    // Compile numeric loops to machine code, only used by the tree walker
+    bool jit_ = false;
+    // Report where the tree walker spends its time at exit, only allowed with the ast engine
+    bool profile_ = false;
+    // File the profile is also written to as collapsed stacks, for flame graph tools
+    std::optional<std::string> profile_stacks_;
+    // Directory where parsed scripts are cached, see AstCache
+    std::optional<std::string> cache_;
+    // Threads that scan large scripts, 0 for one per core
+    uint32_t threads_ = 1;
+    std::optional<std::string> script_;
+};
+
+// Returns std::nullopt if the command line is malformed
+std::optional<Options> ParseOptions(int argc, char** argv);
+
+}  // namespace lox
@@ -0,0 +1,77 @@
+#include "output_sink.hpp"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <lox/numbers.hpp>
+
+namespace lox {
+
+OutputSink::OutputSink(FlushPolicy policy, int fd)
+    : buffer_(std::make_unique<char[]>(kFlushThreshold)), capacity_(kFlushThreshold), policy_(policy), fd_(fd) {
+}
+
+OutputSink::~OutputSink() {
+    Flush();
+}
+
+void OutputSink::Write(std::string_view text) {
+    Reserve(text.size());
+    std::memcpy(buffer_.get() + size_, text.data(), text.size());
+    size_ += text.size();
+}
+
+void OutputSink::Write(double number) {
+    Reserve(kMaxNumberLength);
+    auto text = FormatNumber(number, std::span<char, kMaxNumberLength>(buffer_.get() + size_, kMaxNumberLength));
+    size_ += text.size();
+}
+
+void OutputSink::EndLine() {
+    Write("\n");
+    if (policy_ == FlushPolicy::kLine || (policy_ == FlushPolicy::kBlock && size_ >= kFlushThreshold)) {
+        Flush();
+    }
+}
+
+void OutputSink::Flush() {
+    const char* data = buffer_.get();
+    while (size_ > 0) {
+        auto written = write(fd_, data, size_);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // Nowhere to report it, the output is lost as with a closed std::cout
+            break;
+        }
+        data += written;
+        size_ -= written;
+    }
+    size_ = 0;
+}
+
+FlushPolicy OutputSink::GetPolicy() const {
+    return policy_;
+}
+
+void OutputSink::Reserve(size_t size) {
+    if (size_ + size <= capacity_) {
+        return;
+    }
+    if (policy_ != FlushPolicy::kExit) {
+        Flush();
+        if (size <= capacity_) {
+            return;
+        }
+    }
+    auto capacity = std::max(capacity_ * 2, size_ + size);
+    auto buffer = std::make_unique<char[]>(capacity);
+    std::memcpy(buffer.get(), buffer_.get(), size_);
+    buffer_ = std::move(buffer);
+    capacity_ = capacity;
+}
+
+}  // namespace lox
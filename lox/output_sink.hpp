@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <lox/options.hpp>
+#include <memory>
+#include <string_view>
+
+namespace lox {
+
+// Buffered standard output shared by all engines. Values are formatted straight into the buffer
+// and written to the file descriptor according to the flush policy.
+class OutputSink {
+ public:
+    explicit OutputSink(FlushPolicy policy, int fd = 1);
+    OutputSink(const OutputSink&) = delete;
+    OutputSink& operator=(const OutputSink&) = delete;
+    ~OutputSink();
+
+    void Write(std::string_view text);
+    void Write(double number);
+    // Ends the output of one print statement
+    void EndLine();
+    void Flush();
+    FlushPolicy GetPolicy() const;
+
+ private:
+    void Reserve(size_t size);
+
+ private:
+    static constexpr size_t kFlushThreshold = 64 * 1024;
+
+ private:
+    std::unique_ptr<char[]> buffer_;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+    FlushPolicy policy_;
+    int fd_;
+};
+
+}  // namespace lox
@@ -0,0 +1,83 @@
+#include "thread_pool.hpp"
+
+#include <cassert>
+
+namespace lox {
+
+ThreadPool::ThreadPool(size_t threads_count) {
+    assert(threads_count > 0);
+    workers_.reserve(threads_count - 1);
+    for (size_t i = 1; i < threads_count; ++i) {
+        workers_.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+size_t ThreadPool::GetThreadsCount() const {
+    return workers_.size() + 1;
+}
+
+void ThreadPool::Run(size_t count, const std::function<void(size_t)>& task) {
+    if (workers_.empty() || count <= 1) {
+        for (size_t i = 0; i < count; ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard lock(mutex_);
+        task_ = &task;
+        count_ = count;
+        next_ = 0;
+        active_ = workers_.size();
+        ++generation_;
+    }
+    wake_.notify_all();
+    Work();
+
+    std::unique_lock lock(mutex_);
+    done_.wait(lock, [this] {
+        return active_ == 0;
+    });
+    task_ = nullptr;
+}
+
+void ThreadPool::WorkerLoop() {
+    uint64_t generation = 0;
+    std::unique_lock lock(mutex_);
+    while (true) {
+        wake_.wait(lock, [this, generation] {
+            return stop_ || generation_ != generation;
+        });
+        if (stop_) {
+            return;
+        }
+        generation = generation_;
+
+        lock.unlock();
+        Work();
+        lock.lock();
+        if (--active_ == 0) {
+            done_.notify_one();
+        }
+    }
+}
+
+void ThreadPool::Work() {
+    for (auto i = next_.fetch_add(1); i < count_; i = next_.fetch_add(1)) {
+        (*task_)(i);
+    }
+}
+
+}  // namespace lox
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace lox {
+
+// Fixed set of worker threads that run the indices of one task at a time
+class ThreadPool {
+ public:
+    // `threads_count` includes the calling thread, which takes part in every run
+    explicit ThreadPool(size_t threads_count);
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ~ThreadPool();
+
+    size_t GetThreadsCount() const;
+    // Calls `task` with every index in [0, count) and returns once all calls have finished
+    void Run(size_t count, const std::function<void(size_t)>& task);
+
+ private:
+    void WorkerLoop();
+    // Claims indices of the current task until there are none left
+    void Work();
+
+ private:
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    // Bumped for every run, so each worker joins it exactly once
+    uint64_t generation_ = 0;
+    // Workers that haven't finished the current run
+    size_t active_ = 0;
+    bool stop_ = false;
+    const std::function<void(size_t)>* task_ = nullptr;
+    size_t count_ = 0;
+    std::atomic<size_t> next_ = 0;
+};
+
+}  // namespace lox
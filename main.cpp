@@ -2,18 +2,21 @@
 
 #include <iostream>
 #include <lox/lox.hpp>
+#include <lox/options.hpp>
 
 int main(int argc, char** argv) {
-    if (argc > 2) {
-        std::cerr << "Usage: lox [script]\n";
+    auto options = lox::ParseOptions(argc, argv);
+    if (!options.has_value()) {
+        std::cerr << "Usage: lox [--engine=ast|vm|flat|closure] [--flush=line|block|exit] [-O0|-O1] [--dump-ast] "
+                     "[--emit-c] [--jit] [--cache=dir] [--threads=n] [--profile[=stacks-file]] [script]\n"
+                     "--profile needs the ast engine and can't be combined with --dump-ast or --emit-c\n";
         return EX_USAGE;
     }
 
-    lox::Lox lox;
-    if (argc == 2) {
-        lox.RunFile(argv[1]);
-    } else {
-        lox.RunPrompt();
+    lox::Lox lox(*options);
+    if (options->script_.has_value()) {
+        return lox.RunFile(*options->script_);
     }
+    lox.RunPrompt();
     return 0;
 }
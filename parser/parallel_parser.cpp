@@ -0,0 +1,163 @@
+#include "parallel_parser.hpp"
+
+#include <iterator>
+#include <lox/lox.hpp>
+#include <lox/thread_pool.hpp>
+#include <memory>
+#include <parser/parser.hpp>
+
+namespace lox {
+
+namespace {
+
+constexpr size_t kNoBegin = static_cast<size_t>(-1);
+
+int GetNestingChange(tokens::Type type) {
+    if (type == tokens::Type::kLeftBrace || type == tokens::Type::kLeftParen) {
+        return 1;
+    } else if (type == tokens::Type::kRightBrace || type == tokens::Type::kRightParen) {
+        return -1;
+    }
+    return 0;
+}
+
+}  // namespace
+
+struct ParallelParser::Range {
+    size_t begin_ = 0;
+    // Parsing goes on until a declaration would start at or after it
+    size_t end_ = 0;
+    // Where the next declaration would have started
+    size_t stop_ = 0;
+    // Not movable, hence the pointer
+    std::unique_ptr<Arena> arena_;
+    std::vector<statements::Stmt> statements_;
+    std::vector<DeferredError> errors_;
+};
+
+ParallelParser::ParallelParser(const ScannedSource& scanned, std::string_view source, Arena& arena, Lox& lox,
+                               ThreadPool& pool)
+    : scanned_(scanned), source_(source), arena_(arena), lox_(lox), pool_(pool) {
+}
+
+std::vector<statements::Stmt> ParallelParser::Parse() {
+    MakeConstants();
+    auto bounds = SplitTokens();
+    std::vector<Range> ranges(bounds.size() - 1);
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        ranges[i].end_ = bounds[i + 1];
+    }
+    pool_.Run(ranges.size(), [&](size_t i) {
+        ParseRange(ranges[i], bounds[i]);
+    });
+
+    // Only the first range is sure to start where the sequential parse would start a declaration
+    std::vector<statements::Stmt> statements;
+    size_t statements_count = 0;
+    for (const auto& range : ranges) {
+        statements_count += range.statements_.size();
+    }
+    statements.reserve(statements_count);
+    size_t position = 0;
+    size_t scan_errors_count = 0;
+    for (auto& range : ranges) {
+        if (range.begin_ != position) {
+            // The previous range stopped inside or past the statement this one was guessed to start with
+            ParseRange(range, position);
+        }
+        ReportErrors(range, scan_errors_count);
+        statements.insert(statements.end(), std::make_move_iterator(range.statements_.begin()),
+                          std::make_move_iterator(range.statements_.end()));
+        arena_.Adopt(std::move(*range.arena_));
+        position = range.stop_;
+    }
+    return statements;
+}
+
+std::vector<size_t> ParallelParser::SplitTokens() const {
+    const auto& parts = scanned_.parts_;
+    std::vector<int64_t> depths(parts.size());
+    pool_.Run(parts.size(), [&](size_t i) {
+        for (const auto& token : parts[i].tokens_) {
+            depths[i] += GetNestingChange(token.GetType());
+        }
+    });
+    // Nesting at the start of each part. It may go below zero after unbalanced closing tokens.
+    int64_t depth = 0;
+    for (auto& part_depth : depths) {
+        depth += part_depth;
+        part_depth = depth - part_depth;
+    }
+
+    // A range starts after the first statement of a part that ends at the top level and has no 'else' following
+    std::vector<size_t> begins(parts.size(), kNoBegin);
+    pool_.Run(parts.size(), [&](size_t i) {
+        const auto& tokens = parts[i].tokens_;
+        auto depth = depths[i];
+        for (size_t j = 0; j + 1 < tokens.size(); ++j) {
+            auto type = tokens[j].GetType();
+            depth += GetNestingChange(type);
+            if (depth <= 0 && (type == tokens::Type::kSemicolon || type == tokens::Type::kRightBrace) &&
+                tokens[j + 1].GetType() != tokens::Type::kElse) {
+                begins[i] = parts[i].first_token_ + j + 1;
+                return;
+            }
+        }
+    });
+
+    std::vector<size_t> bounds = {0};
+    for (size_t i = 1; i < parts.size(); ++i) {
+        if (begins[i] != kNoBegin) {
+            bounds.push_back(begins[i]);
+        }
+    }
+    bounds.push_back(parts.empty() ? 0 : parts.back().first_token_ + parts.back().tokens_.size());
+    return bounds;
+}
+
+void ParallelParser::MakeConstants() const {
+    const auto& parts = scanned_.parts_;
+    // Each part's own symbols of its string literals
+    std::vector<std::vector<uint32_t>> strings(parts.size());
+    pool_.Run(parts.size(), [&](size_t i) {
+        std::vector<bool> seen(parts[i].symbols_.size());
+        for (const auto& token : parts[i].tokens_) {
+            auto symbol = static_cast<uint32_t>(token.GetSymbol());
+            if (token.GetType() == tokens::Type::kString && !seen[symbol]) {
+                seen[symbol] = true;
+                strings[i].push_back(symbol);
+            }
+        }
+    });
+
+    auto& constants = lox_.GetConstants();
+    for (size_t i = 0; i < parts.size(); ++i) {
+        for (auto symbol : strings[i]) {
+            constants.GetString(parts[i].symbols_[symbol]);
+        }
+    }
+}
+
+void ParallelParser::ParseRange(Range& range, size_t begin) const {
+    range.begin_ = begin;
+    range.arena_ = std::make_unique<Arena>();
+    range.errors_.clear();
+    Scanner scanner(source_, scanned_, begin, lox_.GetSymbols(), range.errors_);
+    Parser parser(scanner, source_, *range.arena_, lox_, range.errors_);
+    range.statements_ = parser.ParseRange(static_cast<uint32_t>(range.end_ > begin ? range.end_ - begin : 0));
+    range.stop_ = begin + parser.tokens_.GetPosition();
+}
+
+void ParallelParser::ReportErrors(const Range& range, size_t& scan_errors_count) const {
+    for (const auto& error : range.errors_) {
+        if (!error.scan_error_.has_value()) {
+            lox_.Error(error.token_, error.message_);
+        } else if (*error.scan_error_ >= scan_errors_count) {
+            const auto& scan_error = scanned_.errors_[*error.scan_error_];
+            lox_.Error(static_cast<int>(scan_error.line_), scan_error.message_);
+            scan_errors_count = *error.scan_error_ + 1;
+        }
+    }
+}
+
+}  // namespace lox
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <data_structures/arena/arena.hpp>
+#include <data_structures/ast/statements.hpp>
+#include <scanner/scanner.hpp>
+#include <string_view>
+#include <vector>
+
+namespace lox {
+
+class Lox;
+class ThreadPool;
+
+// Produces the same statements as the sequential Parser and reports the same errors in the same order, using every
+// thread of a pool. The tokens are split into ranges on the guess that a top-level statement ends at a ';' or a '}'
+// outside of any braces and parentheses, and the ranges are parsed concurrently, each into its own arena.
+// The guesses are then checked in order, and a range is parsed again from where the previous one really stopped
+// if it was wrong, so error recovery runs over the same tokens as in a sequential parse. Errors are held back and
+// reported range by range.
+class ParallelParser {
+ public:
+    // `scanned` holds the tokens of `source`, the parsed statements point to nodes owned by `arena`
+    ParallelParser(const ScannedSource& scanned, std::string_view source, Arena& arena, Lox& lox, ThreadPool& pool);
+    std::vector<statements::Stmt> Parse();
+
+ private:
+    struct Range;
+
+    // First token of each range, followed by the number of tokens
+    std::vector<size_t> SplitTokens() const;
+    // Creates the constants of the string literals, parsing only reads them then
+    void MakeConstants() const;
+    void ParseRange(Range& range, size_t begin) const;
+    // Skips scan errors below `scan_errors_count`, which the previous range has reported already
+    void ReportErrors(const Range& range, size_t& scan_errors_count) const;
+
+ private:
+    const ScannedSource& scanned_;
+    std::string_view source_;
+    Arena& arena_;
+    Lox& lox_;
+    ThreadPool& pool_;
+};
+
+}  // namespace lox
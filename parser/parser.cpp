@@ -1,5 +1,6 @@
 #include "parser.hpp"
 
+#include <limits>
 #include <lox/lox.hpp>
 
 namespace lox {
@@ -9,12 +10,22 @@ using expressions::MakeExpr;
 using tokens::Token;
 using tokens::Type;
 
-Parser::Parser(std::vector<tokens::Token>&& tokens, Lox& lox) : tokens_(std::move(tokens)), lox_(lox) {
+Parser::Parser(Scanner& scanner, std::string_view source, Arena& arena, Lox& lox)
+    : tokens_(scanner), source_(source), arena_(arena), lox_(lox) {
+}
+
+Parser::Parser(Scanner& scanner, std::string_view source, Arena& arena, Lox& lox,
+               std::vector<DeferredError>& deferred)
+    : tokens_(scanner), source_(source), arena_(arena), lox_(lox), deferred_(&deferred) {
 }
 
 std::vector<statements::Stmt> Parser::Parse() {
+    return ParseRange(std::numeric_limits<uint32_t>::max());
+}
+
+std::vector<statements::Stmt> Parser::ParseRange(uint32_t tokens_count) {
     std::vector<statements::Stmt> statements;
-    while (!IsAtEnd()) {
+    while (!IsAtEnd() && tokens_.GetPosition() < tokens_count) {
         auto stmt = Declaration();
         if (stmt.Is<std::monostate>()) {
             continue;
@@ -42,9 +53,9 @@ expressions::ExprPtr Parser::Assignment() {
         auto value = Assignment();
         if (expr->Is<expressions::Variable>()) {
             auto name = expr->As<expressions::Variable>().name_;
-            return MakeExpr<expressions::Assign>(name, std::move(value));
+            return MakeExpr<expressions::Assign>(arena_, name, std::move(value));
         }
-        lox_.Error(equals, "Invalid assignment target.");
+        Report(equals, "Invalid assignment target.");
     }
     return expr;
 }
@@ -55,7 +66,8 @@ expressions::ExprPtr Parser::Conditional() {
         auto then_branch = Expression();
         Consume(Type::kColon, "Expected ':' after then-branch of ternary conditional expression.");
         auto else_branch = Expression();
-        expr = MakeExpr<expressions::Conditional>(std::move(expr), std::move(then_branch), std::move(else_branch));
+        expr = MakeExpr<expressions::Conditional>(arena_, std::move(expr), std::move(then_branch),
+                                                  std::move(else_branch));
     }
     return expr;
 }
@@ -105,28 +117,30 @@ ExprPtr Parser::Factor() {
 ExprPtr Parser::Unary() {
     if (Match(Type::kBang, Type::kMinus)) {
         Token op = Previous();
-        return MakeExpr<expressions::Unary>(Primary(), std::move(op));
+        return MakeExpr<expressions::Unary>(arena_, Primary(), std::move(op));
     }
     return Primary();
 }
 
 ExprPtr Parser::Primary() {
     if (Match(Type::kFalse)) {
-        return MakeExpr<expressions::Boolean>(false);
+        return MakeExpr<expressions::Boolean>(arena_, false);
     } else if (Match(Type::kTrue)) {
-        return MakeExpr<expressions::Boolean>(true);
+        return MakeExpr<expressions::Boolean>(arena_, true);
     } else if (Match(Type::kNil)) {
-        return MakeExpr<expressions::Nil>();
+        return MakeExpr<expressions::Nil>(arena_);
     } else if (Match(Type::kNumber)) {
-        return MakeExpr<expressions::Number>(Previous().As<tokens::Number>().literal_);
+        return MakeExpr<expressions::Number>(arena_, Previous().GetNumber(source_));
     } else if (Match(Type::kString)) {
-        return MakeExpr<expressions::String>(Previous().As<tokens::String>().literal_);
+        auto symbol = Previous().GetSymbol();
+        const auto& constant = lox_.GetConstants().GetString(symbol);
+        return MakeExpr<expressions::String>(arena_, lox_.GetSymbols().GetName(symbol), constant);
     } else if (Match(Type::kLeftParen)) {
         auto expr = Expression();
         Consume(Type::kRightParen, "Expected ')' after expression.");
-        return MakeExpr<expressions::Grouping>(std::move(expr));
+        return MakeExpr<expressions::Grouping>(arena_, std::move(expr));
     } else if (Match(Type::kIdentifier)) {
-        return MakeExpr<expressions::Variable>(Previous());
+        return MakeExpr<expressions::Variable>(arena_, Previous());
     }
 
     // Error productions
@@ -166,7 +180,7 @@ statements::Stmt Parser::Declaration() {
 
 statements::Stmt Parser::VarDeclaration() {
     auto name = Consume(tokens::Type::kIdentifier, "Expected variable name.");
-    ExprPtr initializer;
+    ExprPtr initializer = nullptr;
     if (Match(tokens::Type::kEqual)) {
         initializer = Expression();
     }
@@ -191,12 +205,14 @@ statements::Stmt Parser::Statement() {
 }
 
 statements::Stmt Parser::PrintStatement() {
+    auto line = Previous().GetLine();
     auto value = Expression();
     Consume(tokens::Type::kSemicolon, "Expected ';' after value.");
-    return statements::MakeStmt<statements::Print>(std::move(value));
+    return statements::MakeStmt<statements::Print>(std::move(value), line);
 }
 
 statements::Stmt Parser::BlockStatement() {
+    auto line = Previous().GetLine();
     std::vector<statements::Stmt> statements;
     while (!Check(tokens::Type::kRightBrace) && !IsAtEnd()) {
         auto stmt = Declaration();
@@ -207,30 +223,34 @@ statements::Stmt Parser::BlockStatement() {
     }
 
     Consume(tokens::Type::kRightBrace, "Expected '}' after block.");
-    return statements::MakeStmt<statements::Block>(std::move(statements));
+    return statements::MakeStmt<statements::Block>(arena_.MakeArray(std::move(statements)), line);
 }
 
 statements::Stmt Parser::IfStatement() {
+    auto line = Previous().GetLine();
     Consume(tokens::Type::kLeftParen, "Expected '(' after 'if'.");
     auto expr = Expression();
     Consume(tokens::Type::kRightParen, "Expected ')' after if condition.");
-    auto then_branch = std::make_shared<statements::Stmt>(Statement());
+    auto then_branch = arena_.Make<statements::Stmt>(Statement());
     if (Match(tokens::Type::kElse)) {
-        auto else_branch = std::make_shared<statements::Stmt>(Statement());
-        return statements::MakeStmt<statements::If>(std::move(expr), std::move(then_branch), std::move(else_branch));
+        auto else_branch = arena_.Make<statements::Stmt>(Statement());
+        return statements::MakeStmt<statements::If>(std::move(expr), std::move(then_branch), std::move(else_branch),
+                                                    line);
     }
-    return statements::MakeStmt<statements::If>(std::move(expr), std::move(then_branch), nullptr);
+    return statements::MakeStmt<statements::If>(std::move(expr), std::move(then_branch), nullptr, line);
 }
 
 statements::Stmt Parser::WhileStatement() {
+    auto line = Previous().GetLine();
     Consume(tokens::Type::kLeftParen, "Expected '(' after 'while'.");
     auto condition = Expression();
     Consume(tokens::Type::kRightParen, "Expected ')' after while condition.");
-    auto statement = std::make_shared<statements::Stmt>(Statement());
-    return statements::MakeStmt<statements::While>(std::move(condition), std::move(statement));
+    auto statement = arena_.Make<statements::Stmt>(Statement());
+    return statements::MakeStmt<statements::While>(std::move(condition), std::move(statement), line);
 }
 
 statements::Stmt Parser::ForStatement() {
+    auto line = Previous().GetLine();
     Consume(tokens::Type::kLeftParen, "Expected '(' after 'for'.");
 
     statements::Stmt initializer;
@@ -240,13 +260,14 @@ statements::Stmt Parser::ForStatement() {
         initializer = ExpressionStatement();
     }
 
-    ExprPtr condition;
+    ExprPtr condition = nullptr;
     if (!Check(tokens::Type::kSemicolon)) {
         condition = Expression();
     }
     Consume(tokens::Type::kSemicolon, "Expected ';' after loop condition.");
 
-    ExprPtr increment;
+    ExprPtr increment = nullptr;
+    auto increment_line = Peek().GetLine();
     if (!Check(tokens::Type::kRightParen)) {
         increment = Expression();
     }
@@ -256,29 +277,30 @@ statements::Stmt Parser::ForStatement() {
 
     // Desugaring
     if (increment != nullptr) {
-        std::vector<statements::Stmt> statements = {std::move(body),
-                                                    statements::MakeStmt<statements::Expression>(std::move(increment))};
-        body = statements::MakeStmt<statements::Block>(std::move(statements));
+        std::vector<statements::Stmt> statements = {
+            std::move(body), statements::MakeStmt<statements::Expression>(std::move(increment), increment_line)};
+        body = statements::MakeStmt<statements::Block>(arena_.MakeArray(std::move(statements)), line);
     }
 
     if (condition == nullptr) {
-        condition = MakeExpr<expressions::Boolean>(true);
+        condition = MakeExpr<expressions::Boolean>(arena_, true);
     }
-    body = statements::MakeStmt<statements::While>(std::move(condition),
-                                                   std::make_shared<statements::Stmt>(std::move(body)));
+    auto* statement = arena_.Make<statements::Stmt>(std::move(body));
+    body = statements::MakeStmt<statements::While>(std::move(condition), statement, line);
 
     if (!initializer.Is<std::monostate>()) {
         std::vector<statements::Stmt> statements = {std::move(initializer), std::move(body)};
-        body = statements::MakeStmt<statements::Block>(std::move(statements));
+        body = statements::MakeStmt<statements::Block>(arena_.MakeArray(std::move(statements)), line);
     }
 
     return body;
 }
 
 statements::Stmt Parser::ExpressionStatement() {
+    auto line = Peek().GetLine();
     auto expr = Expression();
     Consume(tokens::Type::kSemicolon, "Expected ';' after value.");
-    return statements::MakeStmt<statements::Expression>(std::move(expr));
+    return statements::MakeStmt<statements::Expression>(std::move(expr), line);
 }
 
 bool Parser::Check(Type type) const {
@@ -288,9 +310,9 @@ bool Parser::Check(Type type) const {
     return Peek().GetType() == type;
 }
 
-const Token& Parser::Advance() {
+Token Parser::Advance() {
     if (!IsAtEnd()) {
-        ++current_;
+        tokens_.Advance();
     }
     return Previous();
 }
@@ -299,15 +321,15 @@ bool Parser::IsAtEnd() const {
     return Peek().GetType() == Type::kEof;
 }
 
-const Token& Parser::Peek() const {
-    return tokens_[current_];
+Token Parser::Peek() const {
+    return tokens_.Peek();
 }
 
-const Token& Parser::Previous() const {
-    return tokens_[current_ - 1];
+Token Parser::Previous() const {
+    return tokens_.Previous();
 }
 
-const Token& Parser::Consume(Type type, const std::string& message) {
+Token Parser::Consume(Type type, const std::string& message) {
     if (Check(type)) {
         return Advance();
     }
@@ -315,10 +337,18 @@ const Token& Parser::Consume(Type type, const std::string& message) {
 }
 
 ParseError Parser::Error(const tokens::Token& token, const std::string& message) {
-    lox_.Error(token, message);
+    Report(token, message);
     return ParseError("");
 }
 
+void Parser::Report(const tokens::Token& token, const std::string& message) {
+    if (deferred_ != nullptr) {
+        deferred_->push_back({std::nullopt, token, message});
+    } else {
+        lox_.Error(token, message);
+    }
+}
+
 void Parser::Synchronize() {
     Advance();
 
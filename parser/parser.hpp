@@ -1,9 +1,14 @@
 #pragma once
 
+#include <data_structures/arena/arena.hpp>
 #include <data_structures/ast/expressions.hpp>
 #include <data_structures/ast/statements.hpp>
 #include <data_structures/tokens/tokens.hpp>
 #include <lox/errors.hpp>
+#include <scanner/scanner.hpp>
+#include <scanner/token_stream.hpp>
+#include <cstdint>
+#include <string_view>
 #include <vector>
 
 namespace lox {
@@ -41,10 +46,19 @@ class Lox;
 
 class Parser {
  public:
-    Parser(std::vector<tokens::Token>&& tokens, Lox& lox);
+    // Tokens are pulled from `scanner` while parsing. The parsed statements point to nodes owned
+    // by `arena` and hold tokens referring into `source`.
+    Parser(Scanner& scanner, std::string_view source, Arena& arena, Lox& lox);
     std::vector<statements::Stmt> Parse();
 
  private:
+    friend class ParallelParser;
+
+    // Syntax errors are appended to `deferred` instead of being reported
+    Parser(Scanner& scanner, std::string_view source, Arena& arena, Lox& lox, std::vector<DeferredError>& deferred);
+
+    // Parses declarations until at least `tokens_count` tokens were consumed or the source ended
+    std::vector<statements::Stmt> ParseRange(uint32_t tokens_count);
     expressions::ExprPtr Expression();
     expressions::ExprPtr Comma();
     expressions::ExprPtr Assignment();
@@ -69,12 +83,13 @@ class Parser {
     statements::Stmt ExpressionStatement();
 
     bool Check(tokens::Type type) const;
-    const tokens::Token& Advance();
+    tokens::Token Advance();
     bool IsAtEnd() const;
-    const tokens::Token& Peek() const;
-    const tokens::Token& Previous() const;
-    const tokens::Token& Consume(tokens::Type type, const std::string& message);
+    tokens::Token Peek() const;
+    tokens::Token Previous() const;
+    tokens::Token Consume(tokens::Type type, const std::string& message);
     ParseError Error(const tokens::Token& token, const std::string& message);
+    void Report(const tokens::Token& token, const std::string& message);
     void Synchronize();
 
     bool Match(tokens::Type type);
@@ -90,15 +105,17 @@ class Parser {
         while (Match(std::forward<Args>(types)...)) {
             auto op = Previous();
             auto right = sub_expr();
-            expr = MakeExpr<As>(std::move(expr), std::move(right), std::move(op));
+            expr = MakeExpr<As>(arena_, std::move(expr), std::move(right), std::move(op));
         }
         return expr;
     }
 
  private:
-    std::vector<tokens::Token> tokens_;
-    uint32_t current_ = 0;
+    TokenStream tokens_;
+    std::string_view source_;
+    Arena& arena_;
     Lox& lox_;
+    std::vector<DeferredError>* deferred_ = nullptr;
 };
 
 }  // namespace lox
@@ -0,0 +1,119 @@
+#include "parallel_scanner.hpp"
+
+#include <algorithm>
+#include <lox/thread_pool.hpp>
+#include <memory>
+
+namespace lox {
+
+namespace {
+
+// More chunks than threads evens out chunks that are slower to scan
+constexpr size_t kChunksPerThread = 4;
+constexpr size_t kMinChunkLength = size_t{1} << 18;
+
+bool IsWhitespace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+}  // namespace
+
+struct ParallelScanner::Chunk {
+    uint32_t begin_ = 0;
+    uint32_t end_ = 0;
+    // Its tokens end with kEof, which holds where the scan stopped and the line it was on
+    ScannedSource::Part part_;
+    // Lines are counted from 1 at `begin_`, token indices from the chunk's first token
+    std::vector<ScannedSource::Error> errors_;
+    // Not movable, hence the pointer
+    std::unique_ptr<tokens::SymbolTable> symbols_;
+};
+
+ParallelScanner::ParallelScanner(std::string_view source, tokens::SymbolTable& symbols, ThreadPool& pool)
+    : source_(source), symbols_(symbols), pool_(pool) {
+}
+
+ScannedSource ParallelScanner::Scan() {
+    auto bounds = SplitSource();
+    std::vector<Chunk> chunks(bounds.size() - 1);
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        chunks[i].begin_ = bounds[i];
+        chunks[i].end_ = bounds[i + 1];
+    }
+    pool_.Run(chunks.size(), [&](size_t i) {
+        ScanChunk(chunks[i], chunks[i].begin_);
+    });
+
+    // Only the first chunk is sure to start where the sequential scan would start a lexeme
+    ScannedSource result;
+    uint32_t position = 0;
+    uint32_t line = 1;
+    size_t tokens_count = 0;
+    for (auto& chunk : chunks) {
+        if (chunk.begin_ != position) {
+            // The previous chunk ended in a string or a comment running past its end
+            chunk.begin_ = position;
+            ScanChunk(chunk, position);
+        }
+        auto& part = chunk.part_;
+        auto eof = part.tokens_.back();
+        part.tokens_.pop_back();
+        part.line_offset_ = line - 1;
+        part.first_token_ = tokens_count;
+        position = eof.GetOffset();
+        line = eof.GetLine() + part.line_offset_;
+
+        part.symbols_.reserve(chunk.symbols_->GetSize());
+        for (uint32_t symbol = 0; symbol < chunk.symbols_->GetSize(); ++symbol) {
+            part.symbols_.push_back(symbols_.Intern(chunk.symbols_->GetName(tokens::Symbol{symbol})));
+        }
+        for (auto& error : chunk.errors_) {
+            result.errors_.push_back(
+                {error.token_index_ + tokens_count, error.line_ + part.line_offset_, std::move(error.message_)});
+        }
+        tokens_count += part.tokens_.size();
+        result.parts_.push_back(std::move(part));
+    }
+    result.eof_ = tokens::Token(tokens::Type::kEof, position, 0, line);
+    return result;
+}
+
+std::vector<uint32_t> ParallelScanner::SplitSource() const {
+    auto chunks_count =
+        std::clamp<size_t>(source_.length() / kMinChunkLength, 1, pool_.GetThreadsCount() * kChunksPerThread);
+    std::vector<uint32_t> bounds = {0};
+    for (size_t i = 1; i < chunks_count; ++i) {
+        // A chunk starts after a newline and on a lexeme, so the previous chunk's whitespace can't run into it
+        auto position = std::max<size_t>(source_.length() * i / chunks_count, bounds.back());
+        do {
+            position = source_.find('\n', position);
+            if (position == std::string_view::npos) {
+                break;
+            }
+            ++position;
+        } while (position < source_.length() && IsWhitespace(source_[position]));
+
+        if (position >= source_.length()) {
+            break;
+        } else if (position > bounds.back()) {
+            bounds.push_back(position);
+        }
+    }
+    bounds.push_back(source_.length());
+    return bounds;
+}
+
+void ParallelScanner::ScanChunk(Chunk& chunk, uint32_t begin) const {
+    auto& tokens = chunk.part_.tokens_;
+    tokens.clear();
+    // Plenty for typical code, the pages that aren't used are never touched
+    tokens.reserve((std::max(chunk.end_, begin) - begin) / 2 + 1);
+    chunk.errors_.clear();
+    chunk.symbols_ = std::make_unique<tokens::SymbolTable>();
+    Scanner scanner(source_, begin, chunk.end_, *chunk.symbols_, chunk.errors_);
+    do {
+        tokens.push_back(scanner.ScanToken());
+    } while (tokens.back().GetType() != tokens::Type::kEof);
+}
+
+}  // namespace lox
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <data_structures/tokens/symbols.hpp>
+#include <scanner/scanner.hpp>
+#include <string_view>
+#include <vector>
+
+namespace lox {
+
+class ThreadPool;
+
+// Produces the same tokens, symbols and errors as scanning the source sequentially, using every thread of a pool.
+// The source is split into chunks at line starts, which are scanned concurrently on the guess that none of them
+// starts inside a string or a block comment. The guesses are then checked in order, and a chunk is scanned again
+// from where the previous one really ended if it was wrong. Each chunk interns into its own SymbolTable,
+// whose names are interned into the shared one chunk by chunk, so symbols are numbered as in a sequential scan.
+class ParallelScanner {
+ public:
+    // Smaller sources aren't worth splitting
+    static constexpr size_t kMinSourceLength = size_t{1} << 20;
+
+    ParallelScanner(std::string_view source, tokens::SymbolTable& symbols, ThreadPool& pool);
+    ScannedSource Scan();
+
+ private:
+    struct Chunk;
+
+    // Start of each chunk, followed by the length of the source
+    std::vector<uint32_t> SplitSource() const;
+    void ScanChunk(Chunk& chunk, uint32_t begin) const;
+
+ private:
+    std::string_view source_;
+    tokens::SymbolTable& symbols_;
+    ThreadPool& pool_;
+};
+
+}  // namespace lox
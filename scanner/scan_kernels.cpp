@@ -0,0 +1,178 @@
+#include "scan_kernels.hpp"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace lox::scan {
+
+namespace {
+
+bool IsWhitespace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+const char* SkipWhitespaceScalar(const char* first, const char* last, uint32_t& lines) {
+    for (; first != last && IsWhitespace(*first); ++first) {
+        lines += *first == '\n';
+    }
+    return first;
+}
+
+const char* FindAnyOfScalar(const char* first, const char* last, char a, char b, char c) {
+    for (; first != last; ++first) {
+        if (*first == a || *first == b || *first == c) {
+            return first;
+        }
+    }
+    return last;
+}
+
+uint32_t CountNewlinesScalar(const char* first, const char* last) {
+    uint32_t lines = 0;
+    for (; first != last; ++first) {
+        lines += *first == '\n';
+    }
+    return lines;
+}
+
+#if defined(__x86_64__)
+
+// SSE2 is part of x86-64, so these need no target attribute
+
+const char* SkipWhitespaceSse2(const char* first, const char* last, uint32_t& lines) {
+    const auto space = _mm_set1_epi8(' ');
+    const auto tab = _mm_set1_epi8('\t');
+    const auto carriage_return = _mm_set1_epi8('\r');
+    const auto newline = _mm_set1_epi8('\n');
+    for (; last - first >= 16; first += 16) {
+        auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        auto newlines = _mm_cmpeq_epi8(block, newline);
+        auto blanks = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, space), _mm_cmpeq_epi8(block, tab)),
+                                   _mm_or_si128(_mm_cmpeq_epi8(block, carriage_return), newlines));
+        uint32_t newline_mask = _mm_movemask_epi8(newlines);
+        uint32_t other_mask = ~_mm_movemask_epi8(blanks) & 0xffff;
+        if (other_mask != 0) {
+            auto offset = __builtin_ctz(other_mask);
+            lines += __builtin_popcount(newline_mask & ((1u << offset) - 1));
+            return first + offset;
+        }
+        lines += __builtin_popcount(newline_mask);
+    }
+    return SkipWhitespaceScalar(first, last, lines);
+}
+
+const char* FindAnyOfSse2(const char* first, const char* last, char a, char b, char c) {
+    const auto first_char = _mm_set1_epi8(a);
+    const auto second_char = _mm_set1_epi8(b);
+    const auto third_char = _mm_set1_epi8(c);
+    for (; last - first >= 16; first += 16) {
+        auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        auto matches = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, first_char), _mm_cmpeq_epi8(block, second_char)),
+                                    _mm_cmpeq_epi8(block, third_char));
+        if (uint32_t mask = _mm_movemask_epi8(matches); mask != 0) {
+            return first + __builtin_ctz(mask);
+        }
+    }
+    return FindAnyOfScalar(first, last, a, b, c);
+}
+
+uint32_t CountNewlinesSse2(const char* first, const char* last) {
+    const auto newline = _mm_set1_epi8('\n');
+    uint32_t lines = 0;
+    for (; last - first >= 16; first += 16) {
+        auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        lines += __builtin_popcount(_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline)));
+    }
+    return lines + CountNewlinesScalar(first, last);
+}
+
+__attribute__((target("avx2,popcnt"))) const char* SkipWhitespaceAvx2(const char* first, const char* last,
+                                                                      uint32_t& lines) {
+    const auto space = _mm256_set1_epi8(' ');
+    const auto tab = _mm256_set1_epi8('\t');
+    const auto carriage_return = _mm256_set1_epi8('\r');
+    const auto newline = _mm256_set1_epi8('\n');
+    for (; last - first >= 32; first += 32) {
+        auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+        auto newlines = _mm256_cmpeq_epi8(block, newline);
+        auto blanks =
+            _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(block, space), _mm256_cmpeq_epi8(block, tab)),
+                            _mm256_or_si256(_mm256_cmpeq_epi8(block, carriage_return), newlines));
+        uint32_t newline_mask = _mm256_movemask_epi8(newlines);
+        uint32_t other_mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(blanks));
+        if (other_mask != 0) {
+            auto offset = __builtin_ctz(other_mask);
+            lines += __builtin_popcount(newline_mask & ((1u << offset) - 1));
+            return first + offset;
+        }
+        lines += __builtin_popcount(newline_mask);
+    }
+    return SkipWhitespaceSse2(first, last, lines);
+}
+
+__attribute__((target("avx2,popcnt"))) const char* FindAnyOfAvx2(const char* first, const char* last, char a, char b,
+                                                                  char c) {
+    const auto first_char = _mm256_set1_epi8(a);
+    const auto second_char = _mm256_set1_epi8(b);
+    const auto third_char = _mm256_set1_epi8(c);
+    for (; last - first >= 32; first += 32) {
+        auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+        auto matches = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, first_char), _mm256_cmpeq_epi8(block, second_char)),
+            _mm256_cmpeq_epi8(block, third_char));
+        if (uint32_t mask = _mm256_movemask_epi8(matches); mask != 0) {
+            return first + __builtin_ctz(mask);
+        }
+    }
+    return FindAnyOfSse2(first, last, a, b, c);
+}
+
+__attribute__((target("avx2,popcnt"))) uint32_t CountNewlinesAvx2(const char* first, const char* last) {
+    const auto newline = _mm256_set1_epi8('\n');
+    uint32_t lines = 0;
+    for (; last - first >= 32; first += 32) {
+        auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+        lines += __builtin_popcount(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, newline)));
+    }
+    return lines + CountNewlinesSse2(first, last);
+}
+
+#endif
+
+struct Kernels {
+    const char* (*skip_whitespace_)(const char*, const char*, uint32_t&);
+    const char* (*find_any_of_)(const char*, const char*, char, char, char);
+    uint32_t (*count_newlines_)(const char*, const char*);
+};
+
+Kernels SelectKernels() {
+#if defined(__x86_64__)
+    // Runs during static initialization, possibly before libgcc has filled in the CPU model
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+        return {SkipWhitespaceAvx2, FindAnyOfAvx2, CountNewlinesAvx2};
+    }
+    return {SkipWhitespaceSse2, FindAnyOfSse2, CountNewlinesSse2};
+#else
+    return {SkipWhitespaceScalar, FindAnyOfScalar, CountNewlinesScalar};
+#endif
+}
+
+const Kernels kKernels = SelectKernels();
+
+}  // namespace
+
+const char* SkipWhitespace(const char* first, const char* last, uint32_t& lines) {
+    return kKernels.skip_whitespace_(first, last, lines);
+}
+
+const char* FindAnyOf(const char* first, const char* last, char a, char b, char c) {
+    return kKernels.find_any_of_(first, last, a, b, c);
+}
+
+uint32_t CountNewlines(const char* first, const char* last) {
+    return kKernels.count_newlines_(first, last);
+}
+
+}  // namespace lox::scan
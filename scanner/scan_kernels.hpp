@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+// Byte-scanning loops of the scanner. On x86-64 they process 16 or 32 bytes at a time
+// with SSE2 or AVX2, picked at startup from what the CPU supports; elsewhere they are scalar.
+namespace lox::scan {
+
+// Returns the first position in [first, last) that isn't ' ', '\t', '\r' or '\n', or `last`.
+// Adds the number of skipped '\n' to `lines`.
+const char* SkipWhitespace(const char* first, const char* last, uint32_t& lines);
+
+// Returns the first position in [first, last) holding `a`, `b` or `c`, or `last`
+const char* FindAnyOf(const char* first, const char* last, char a, char b, char c);
+
+// Returns the number of '\n' in [first, last)
+uint32_t CountNewlines(const char* first, const char* last);
+
+}  // namespace lox::scan
@@ -1,42 +1,124 @@
 #include "scanner.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <lox/lox.hpp>
+#include <lox/thread_pool.hpp>
+#include <scanner/parallel_scanner.hpp>
+#include <scanner/scan_kernels.hpp>
 
 namespace lox {
 
-const std::unordered_map<std::string, tokens::Type> Scanner::kKeywords = {
-    {"and", tokens::Type::kAnd},        //
-    {"class", tokens::Type::kClass},    //
-    {"else", tokens::Type::kElse},      //
-    {"false", tokens::Type::kFalse},    //
-    {"for", tokens::Type::kFor},        //
-    {"fun", tokens::Type::kFun},        //
-    {"if", tokens::Type::kIf},          //
-    {"nil", tokens::Type::kNil},        //
-    {"or", tokens::Type::kOr},          //
-    {"print", tokens::Type::kPrint},    //
-    {"return", tokens::Type::kReturn},  //
-    {"super", tokens::Type::kSuper},    //
-    {"this", tokens::Type::kThis},      //
-    {"true", tokens::Type::kTrue},      //
-    {"var", tokens::Type::kVar},        //
-    {"while", tokens::Type::kWhile},    //
-};
-
-Scanner::Scanner(std::string&& source, Lox& lox) : source_(std::move(source)), lox_(lox) {
+Scanner::Scanner(std::string_view source, Lox& lox, ThreadPool* pool)
+    : source_(source), end_(source.length()), symbols_(lox.GetSymbols()), lox_(&lox) {
+    if (pool != nullptr && pool->GetThreadsCount() > 1 && source.length() >= ParallelScanner::kMinSourceLength) {
+        scanned_ = ParallelScanner(source, symbols_, *pool).Scan();
+        replayed_ = &*scanned_;
+    }
+}
+
+Scanner::Scanner(std::string_view source, uint32_t begin, uint32_t end, tokens::SymbolTable& symbols,
+                 std::vector<ScannedSource::Error>& errors)
+    : source_(source), end_(end), current_(begin), symbols_(symbols), errors_(&errors) {
+}
+
+Scanner::Scanner(std::string_view source, const ScannedSource& scanned, size_t first_token,
+                 tokens::SymbolTable& symbols, std::vector<DeferredError>& deferred)
+    : source_(source),
+      end_(source.length()),
+      symbols_(symbols),
+      deferred_(&deferred),
+      tokens_count_(first_token),
+      replayed_(&scanned) {
+    const auto& parts = scanned.parts_;
+    auto part = std::upper_bound(parts.begin(), parts.end(), first_token, [](size_t index, const auto& part) {
+        return index < part.first_token_;
+    });
+    if (part != parts.begin()) {
+        --part;
+        replayed_parts_count_ = part - parts.begin();
+        replayed_tokens_count_ = std::min(first_token - part->first_token_, part->tokens_.size());
+    }
+    // Errors of the first token are replayed again, in case no one before has reported them
+    auto error = std::lower_bound(scanned.errors_.begin(), scanned.errors_.end(), first_token,
+                                  [](const auto& error, size_t index) {
+                                      return error.token_index_ < index;
+                                  });
+    replayed_errors_count_ = error - scanned.errors_.begin();
 }
 
 std::vector<tokens::Token> Scanner::ScanTokens() {
-    while (!IsAtEnd()) {
+    std::vector<tokens::Token> tokens;
+    do {
+        tokens.push_back(ScanToken());
+    } while (tokens.back().GetType() != tokens::Type::kEof);
+    return tokens;
+}
+
+const ScannedSource* Scanner::GetScanned() const {
+    return scanned_.has_value() ? &*scanned_ : nullptr;
+}
+
+tokens::Token Scanner::ScanToken() {
+    if (replayed_ != nullptr) {
+        return ReplayToken();
+    }
+    while (current_ < end_) {
         start_ = current_;
-        ScanToken();
+        ScanLexeme();
+        if (token_.has_value()) {
+            auto token = *token_;
+            token_.reset();
+            ++tokens_count_;
+            return token;
+        }
     }
-    tokens_.emplace_back(tokens::NonLiteral(tokens::Type::kEof, "", line_));
-    return std::move(tokens_);
+    return {tokens::Type::kEof, current_, 0, line_};
 }
 
-void Scanner::ScanToken() {
+tokens::Token Scanner::ReplayToken() {
+    const auto& errors = replayed_->errors_;
+    for (; replayed_errors_count_ < errors.size(); ++replayed_errors_count_) {
+        const auto& error = errors[replayed_errors_count_];
+        if (error.token_index_ > tokens_count_) {
+            break;
+        }
+        if (deferred_ != nullptr) {
+            deferred_->push_back({replayed_errors_count_, {}, {}});
+        } else {
+            lox_->Error(static_cast<int>(error.line_), error.message_);
+        }
+    }
+    ++tokens_count_;
+
+    const auto& parts = replayed_->parts_;
+    while (replayed_parts_count_ < parts.size() &&
+           replayed_tokens_count_ == parts[replayed_parts_count_].tokens_.size()) {
+        ++replayed_parts_count_;
+        replayed_tokens_count_ = 0;
+    }
+    if (replayed_parts_count_ == parts.size()) {
+        return replayed_->eof_;
+    }
+
+    const auto& part = parts[replayed_parts_count_];
+    const auto& token = part.tokens_[replayed_tokens_count_++];
+    auto symbol = token.GetSymbol();
+    if (token.GetType() == tokens::Type::kIdentifier || token.GetType() == tokens::Type::kString) {
+        symbol = part.symbols_[static_cast<uint32_t>(symbol)];
+    }
+    return {token.GetType(), token.GetOffset(), token.GetLength(), token.GetLine() + part.line_offset_, symbol};
+}
+
+void Scanner::Error(const std::string& message) {
+    if (lox_ != nullptr) {
+        lox_->Error(static_cast<int>(line_), message);
+    } else {
+        errors_->push_back({tokens_count_, line_, message});
+    }
+}
+
+void Scanner::ScanLexeme() {
     char c = Advance();
     if (c == '(') {
         AddToken(tokens::Type::kLeftParen);
@@ -77,10 +159,10 @@ void Scanner::ScanToken() {
     } else if (c == '/') {
         AddToken(tokens::Type::kSlash);
     } else if (c == ' ' || c == '\r' || c == '\t') {
-        // Skip
-        return;
+        SkipWhitespace();
     } else if (c == '\n') {
         ++line_;
+        SkipWhitespace();
     } else if (c == '"') {
         ScanString();
     } else if (IsDigit(c)) {
@@ -88,7 +170,7 @@ void Scanner::ScanToken() {
     } else if (IsAlpha(c)) {
         ScanIdentifierOrKeyword();
     } else {
-        lox_.Error(line_, "Unexpected character.");
+        Error("Unexpected character.");
     }
 }
 
@@ -100,17 +182,12 @@ char Scanner::Advance() {
     return source_[current_++];
 }
 
-void Scanner::AddToken(tokens::Type type, std::optional<std::string>&& literal) {
-    std::string lexeme = source_.substr(start_, current_ - start_);
-    if (type == tokens::Type::kNumber) {
-        assert(literal.has_value());
-        tokens_.emplace_back(tokens::Number(type, std::move(lexeme), std::stod(*literal), line_));
-    } else if (type == tokens::Type::kString) {
-        assert(literal.has_value());
-        tokens_.emplace_back(tokens::String(type, std::move(lexeme), std::move(*literal), line_));
-    } else {
-        tokens_.emplace_back(tokens::NonLiteral(type, std::move(lexeme), line_));
+void Scanner::AddToken(tokens::Type type, tokens::Symbol symbol) {
+    if (current_ - start_ > tokens::Token::kMaxLength) {
+        Error("Token is too long.");
+        return;
     }
+    token_.emplace(type, start_, current_ - start_, line_, symbol);
 }
 
 bool Scanner::Match(char expected) {
@@ -137,15 +214,12 @@ char Scanner::PeekNext() const {
 }
 
 void Scanner::ScanString() {
-    while (Peek() != '"' && !IsAtEnd()) {
-        if (Peek() == '\n') {
-            ++line_;
-        }
-        Advance();
-    }
+    auto end = std::min(source_.find('"', current_), source_.length());
+    line_ += scan::CountNewlines(source_.data() + current_, source_.data() + end);
+    current_ = end;
 
     if (IsAtEnd()) {
-        lox_.Error(line_, "Unterminated string.");
+        Error("Unterminated string.");
         return;
     }
 
@@ -153,8 +227,8 @@ void Scanner::ScanString() {
     Advance();
 
     // Trim quotes
-    std::string literal = source_.substr(start_ + 1, current_ - start_ - 2);
-    AddToken(tokens::Type::kString, std::move(literal));
+    auto literal = source_.substr(start_ + 1, current_ - start_ - 2);
+    AddToken(tokens::Type::kString, symbols_.Intern(literal));
 }
 
 void Scanner::ScanNumber() {
@@ -169,7 +243,7 @@ void Scanner::ScanNumber() {
             Advance();
         }
     }
-    AddToken(tokens::Type::kNumber, source_.substr(start_, current_ - start_));
+    AddToken(tokens::Type::kNumber);
 }
 
 void Scanner::ScanIdentifierOrKeyword() {
@@ -177,25 +251,29 @@ void Scanner::ScanIdentifierOrKeyword() {
         Advance();
     }
 
-    std::string text = source_.substr(start_, current_ - start_);
-    if (kKeywords.contains(text)) {
-        AddToken(kKeywords.at(text));
+    auto symbol = symbols_.Intern(source_.substr(start_, current_ - start_));
+    if (auto keyword = symbols_.GetKeyword(symbol); keyword.has_value()) {
+        AddToken(*keyword);
     } else {
-        AddToken(tokens::Type::kIdentifier);
+        AddToken(tokens::Type::kIdentifier, symbol);
     }
 }
 
+void Scanner::SkipWhitespace() {
+    const auto* first = source_.data() + current_;
+    current_ += scan::SkipWhitespace(first, source_.data() + source_.length(), line_) - first;
+}
+
 void Scanner::SkipLineComment() {
-    while (Peek() != '\n' && !IsAtEnd()) {
-        Advance();
-    }
+    // The newline is left for ScanLexeme to count
+    current_ = std::min(source_.find('\n', current_), source_.length());
 }
 
 void Scanner::SkipBlockComment() {
     size_t nesting = 1;
     while (nesting > 0) {
         if (Peek() == '\0') {
-            lox_.Error(line_, "Unterminated block comment.");
+            Error("Unterminated block comment.");
             return;
         }
 
@@ -211,7 +289,9 @@ void Scanner::SkipBlockComment() {
             continue;
         }
 
-        Advance();
+        // Nothing else can open or close a comment
+        const auto* first = source_.data() + current_ + 1;
+        current_ = scan::FindAnyOf(first, source_.data() + source_.length(), '/', '*', '\0') - source_.data();
     }
 }
 
@@ -3,23 +3,76 @@
 #include <data_structures/tokens/tokens.hpp>
 #include <optional>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <vector>
 
 namespace lox {
 
 class Lox;
+class ThreadPool;
+
+// Tokens of a whole source scanned in parts, with its errors in the order a sequential scan reports them
+struct ScannedSource {
+    struct Error {
+        // Reported right before this token is returned
+        size_t token_index_;
+        uint32_t line_;
+        std::string message_;
+    };
+
+    // Tokens are fixed up as they are replayed, which saves a pass over all of them
+    struct Part {
+        // Lines are counted from 1 at the start of the part
+        std::vector<tokens::Token> tokens_;
+        uint32_t line_offset_ = 0;
+        // Index of its first token in the whole source
+        size_t first_token_ = 0;
+        // Shared symbol of each symbol in the part's own table
+        std::vector<tokens::Symbol> symbols_;
+    };
+
+    std::vector<Part> parts_;
+    std::vector<Error> errors_;
+    tokens::Token eof_;
+};
+
+// Error met off the main thread, reported once everything before it has been
+struct DeferredError {
+    // Index in ScannedSource::errors_ of a scan error, otherwise it is a syntax error at `token_`
+    std::optional<size_t> scan_error_;
+    tokens::Token token_;
+    std::string message_;
+};
 
 class Scanner {
  public:
-    Scanner(std::string&& source, Lox& lox);
+    // Tokens refer into `source`, which must outlive them.
+    // With a pool, a large source is scanned up front in parallel and then replayed token by token.
+    Scanner(std::string_view source, Lox& lox, ThreadPool* pool = nullptr);
     std::vector<tokens::Token> ScanTokens();
+    // Scans up to the next token, returns kEof at the end of the source
+    tokens::Token ScanToken();
+    // Tokens of the whole source if it was scanned up front, nullptr otherwise
+    const ScannedSource* GetScanned() const;
 
  private:
-    void ScanToken();
+    friend class ParallelParser;
+    friend class ParallelScanner;
+
+    // Scans the lexemes starting in [begin, end) with lines counted from 1, interning into `symbols`.
+    // Errors are collected in `errors` instead of being reported.
+    Scanner(std::string_view source, uint32_t begin, uint32_t end, tokens::SymbolTable& symbols,
+            std::vector<ScannedSource::Error>& errors);
+    // Replays the tokens of `scanned` from its token `first_token` on, appending its errors to `deferred`
+    Scanner(std::string_view source, const ScannedSource& scanned, size_t first_token, tokens::SymbolTable& symbols,
+            std::vector<DeferredError>& deferred);
+
+    tokens::Token ReplayToken();
+    void Error(const std::string& message);
+    void ScanLexeme();
     bool IsAtEnd() const;
     char Advance();
-    void AddToken(tokens::Type type, std::optional<std::string>&& literal = std::nullopt);
+    void AddToken(tokens::Type type, tokens::Symbol symbol = {});
     bool Match(char expected);
     char Peek() const;
     void ScanString();
@@ -27,6 +80,7 @@ class Scanner {
     char PeekNext() const;
     char PeekImpl(size_t shift) const;
     void ScanIdentifierOrKeyword();
+    void SkipWhitespace();
     void SkipLineComment();
     void SkipBlockComment();
 
@@ -35,15 +89,29 @@ class Scanner {
     static bool IsAlphaNumeric(unsigned char c);
 
  private:
-    static const std::unordered_map<std::string, tokens::Type> kKeywords;
-
- private:
-    std::string source_;
-    std::vector<tokens::Token> tokens_;
+    std::string_view source_;
+    // No lexeme starts at or after it, the kEof token is returned instead
+    uint32_t end_ = 0;
+    // Set by AddToken for ScanToken to return
+    std::optional<tokens::Token> token_;
     uint32_t start_ = 0;
     uint32_t current_ = 0;
     uint32_t line_ = 1;
-    Lox& lox_;
+    tokens::SymbolTable& symbols_;
+    // Errors go to `lox_` if it is set, otherwise to `errors_`, replayed ones to `deferred_` if it is set
+    Lox* lox_ = nullptr;
+    std::vector<ScannedSource::Error>* errors_ = nullptr;
+    std::vector<DeferredError>* deferred_ = nullptr;
+    // Tokens returned so far, counted from the start of the source
+    size_t tokens_count_ = 0;
+    // Set when the source was scanned in parallel
+    std::optional<ScannedSource> scanned_;
+    // What is replayed, `scanned_` or the tokens of another scanner
+    const ScannedSource* replayed_ = nullptr;
+    size_t replayed_errors_count_ = 0;
+    size_t replayed_parts_count_ = 0;
+    // Index in the current part
+    size_t replayed_tokens_count_ = 0;
 };
 
 }  // namespace lox
@@ -0,0 +1,17 @@
+#include "token_stream.hpp"
+
+#include <cassert>
+
+namespace lox {
+
+TokenStream::TokenStream(Scanner& scanner) : scanner_(scanner) {
+    buffer_[0] = scanner_.ScanToken();
+}
+
+void TokenStream::Advance() {
+    assert(Peek().GetType() != tokens::Type::kEof);
+    ++position_;
+    buffer_[position_ & kMask] = scanner_.ScanToken();
+}
+
+}  // namespace lox
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <data_structures/tokens/tokens.hpp>
+#include <scanner/scanner.hpp>
+
+namespace lox {
+
+// Pulls tokens from a Scanner on demand. Only the last few tokens are kept,
+// so memory doesn't grow with the size of the source.
+class TokenStream {
+ public:
+    explicit TokenStream(Scanner& scanner);
+
+    const tokens::Token& Peek() const {
+        return buffer_[position_ & kMask];
+    }
+
+    const tokens::Token& Previous() const {
+        return buffer_[(position_ - 1) & kMask];
+    }
+
+    // Moves past the current token, which must not be kEof
+    void Advance();
+
+    // Number of tokens consumed so far
+    uint32_t GetPosition() const {
+        return position_;
+    }
+
+ private:
+    static constexpr uint32_t kCapacity = 4;
+    static constexpr uint32_t kMask = kCapacity - 1;
+    static_assert((kCapacity & kMask) == 0, "Capacity must be a power of two");
+
+ private:
+    std::array<tokens::Token, kCapacity> buffer_;
+    // Number of tokens consumed so far
+    uint32_t position_ = 0;
+    Scanner& scanner_;
+};
+
+}  // namespace lox
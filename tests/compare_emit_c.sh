@@ -0,0 +1,35 @@
+#!/bin/sh
+# Translates each script with --emit-c, builds and runs the program, and fails if its stdout, stderr or exit status
+# differ from running the script on the tree walker.
+# Usage: compare_emit_c.sh <lox> <c++ compiler> <script>...
+lox=$1
+cxx=$2
+shift 2
+out=$(mktemp -d) || exit 1
+trap 'rm -rf "$out"' EXIT
+
+failed=0
+for script in "$@"; do
+    if ! "$lox" --emit-c "$script" >"$out/program.cpp"; then
+        echo "FAIL $script: --emit-c failed"
+        failed=1
+        continue
+    fi
+    if ! "$cxx" -std=c++17 -O1 "$out/program.cpp" -o "$out/program"; then
+        echo "FAIL $script: the translated program doesn't build"
+        failed=1
+        continue
+    fi
+    "$lox" "$script" >"$out/expected.out" 2>"$out/expected.err"
+    expected_status=$?
+    "$out/program" >"$out/actual.out" 2>"$out/actual.err"
+    actual_status=$?
+    if ! cmp -s "$out/expected.out" "$out/actual.out" || ! cmp -s "$out/expected.err" "$out/actual.err" ||
+        [ "$expected_status" -ne "$actual_status" ]; then
+        echo "FAIL $script: exit status $expected_status interpreted, $actual_status translated"
+        diff "$out/expected.out" "$out/actual.out"
+        diff "$out/expected.err" "$out/actual.err"
+        failed=1
+    fi
+done
+exit $failed
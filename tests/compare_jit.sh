@@ -0,0 +1,23 @@
+#!/bin/sh
+# Runs each script on the tree walker with and without --jit, and fails if stdout, stderr or the exit status differ.
+# Usage: compare_jit.sh <lox> <script>...
+lox=$1
+shift
+out=$(mktemp -d) || exit 1
+trap 'rm -rf "$out"' EXIT
+
+failed=0
+for script in "$@"; do
+    "$lox" "$script" >"$out/expected.out" 2>"$out/expected.err"
+    expected_status=$?
+    "$lox" --jit "$script" >"$out/actual.out" 2>"$out/actual.err"
+    actual_status=$?
+    if ! cmp -s "$out/expected.out" "$out/actual.out" || ! cmp -s "$out/expected.err" "$out/actual.err" ||
+        [ "$expected_status" -ne "$actual_status" ]; then
+        echo "FAIL $script: exit status $expected_status without --jit, $actual_status with it"
+        diff "$out/expected.out" "$out/actual.out"
+        diff "$out/expected.err" "$out/actual.err"
+        failed=1
+    fi
+done
+exit $failed
@@ -0,0 +1,77 @@
+#include "chunk.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace lox::vm {
+
+void Chunk::Write(uint8_t byte, uint32_t line) {
+    if (lines_.empty() || lines_.back().line_ != line) {
+        lines_.push_back({code_.size(), line});
+    }
+    code_.push_back(byte);
+}
+
+void Chunk::Write(OpCode op, uint32_t line) {
+    Write(static_cast<uint8_t>(op), line);
+}
+
+void Chunk::WriteOperand(uint32_t operand, size_t width, uint32_t line) {
+    for (size_t i = 0; i < width; ++i) {
+        Write(static_cast<uint8_t>(operand >> (8 * i)), line);
+    }
+}
+
+void Chunk::PatchOperand(size_t offset, uint32_t operand, size_t width) {
+    assert(offset + width <= code_.size());
+    for (size_t i = 0; i < width; ++i) {
+        code_[offset + i] = static_cast<uint8_t>(operand >> (8 * i));
+    }
+}
+
+size_t Chunk::AddConstant(Value value) {
+    constants_.push_back(std::move(value));
+    return constants_.size() - 1;
+}
+
+void Chunk::AddLocalName(uint16_t slot, size_t start, size_t end, tokens::Symbol name) {
+    local_names_.push_back({slot, start, end, name});
+}
+
+const std::vector<uint8_t>& Chunk::GetCode() const {
+    return code_;
+}
+
+const Value& Chunk::GetConstant(size_t index) const {
+    return constants_[index];
+}
+
+size_t Chunk::GetConstantsCount() const {
+    return constants_.size();
+}
+
+uint32_t Chunk::GetLine(size_t offset) const {
+    auto it = std::upper_bound(lines_.begin(), lines_.end(), offset, [](size_t offset, const LineStart& start) {
+        return offset < start.offset_;
+    });
+    assert(it != lines_.begin());
+    return std::prev(it)->line_;
+}
+
+tokens::Symbol Chunk::GetLocalName(uint16_t slot, size_t offset) const {
+    auto it = std::find_if(local_names_.begin(), local_names_.end(), [slot, offset](const LocalName& local) {
+        return local.slot_ == slot && local.start_ <= offset && offset < local.end_;
+    });
+    assert(it != local_names_.end());
+    return it->name_;
+}
+
+uint32_t Chunk::ReadOperand(const uint8_t* code, size_t width) {
+    uint32_t operand = 0;
+    for (size_t i = 0; i < width; ++i) {
+        operand |= static_cast<uint32_t>(code[i]) << (8 * i);
+    }
+    return operand;
+}
+
+}  // namespace lox::vm
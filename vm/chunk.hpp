@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <data_structures/ast/value.hpp>
+#include <data_structures/tokens/symbols.hpp>
+#include <vector>
+
+namespace lox::vm {
+
+// Operand widths: local slots are 16-bit, constant and global indices are 24-bit,
+// jump offsets are 32-bit. All operands are little-endian.
+enum class OpCode : uint8_t {
+    kConstant,       // [index:24] -> value
+    kNil,            // -> nil
+    kTrue,           // -> true
+    kFalse,          // -> false
+    kUninitialized,  // -> uninitialized
+    kPop,            // value ->
+    kPopN,           // [count:16] values ->
+    kGetLocal,       // [slot:16] -> value
+    kSetLocal,       // [slot:16] value -> value
+    kGetGlobal,      // [index:24] -> value
+    kDefineGlobal,   // [index:24] value ->
+    kSetGlobal,      // [index:24] value -> value
+    kEqual,          // lhs rhs -> bool
+    kNotEqual,       // lhs rhs -> bool
+    kGreater,        // lhs rhs -> bool
+    kGreaterEqual,   // lhs rhs -> bool
+    kLess,           // lhs rhs -> bool
+    kLessEqual,      // lhs rhs -> bool
+    kAdd,            // lhs rhs -> sum or concatenation
+    kSubtract,       // lhs rhs -> number
+    kMultiply,       // lhs rhs -> number
+    kDivide,         // lhs rhs -> number
+    kNot,            // value -> bool
+    kNegate,         // value -> number
+    kPrint,          // value ->
+    kJump,           // [offset:32] forward jump
+    kJumpIfFalse,    // [offset:32] forward jump, condition stays on the stack
+    kJumpIfTrue,     // [offset:32] forward jump, condition stays on the stack
+    kPopJumpIfFalse, // [offset:32] forward jump, condition is popped
+    kLoop,           // [offset:32] backward jump
+    kReturn,
+};
+
+inline constexpr size_t kSlotWidth = 2;
+inline constexpr size_t kIndexWidth = 3;
+inline constexpr size_t kJumpWidth = 4;
+
+inline constexpr uint32_t kMaxSlots = 1u << (8 * kSlotWidth);
+inline constexpr uint32_t kMaxIndices = 1u << (8 * kIndexWidth);
+
+class Chunk {
+ public:
+    void Write(uint8_t byte, uint32_t line);
+    void Write(OpCode op, uint32_t line);
+    void WriteOperand(uint32_t operand, size_t width, uint32_t line);
+    void PatchOperand(size_t offset, uint32_t operand, size_t width);
+    size_t AddConstant(Value value);
+    void AddLocalName(uint16_t slot, size_t start, size_t end, tokens::Symbol name);
+
+    const std::vector<uint8_t>& GetCode() const;
+    const Value& GetConstant(size_t index) const;
+    size_t GetConstantsCount() const;
+    uint32_t GetLine(size_t offset) const;
+    tokens::Symbol GetLocalName(uint16_t slot, size_t offset) const;
+
+    static uint32_t ReadOperand(const uint8_t* code, size_t width);
+
+ private:
+    // Run-length encoded line table: the line of the instruction at `offset_`
+    // and of all the following ones up to the next entry
+    struct LineStart {
+        size_t offset_;
+        uint32_t line_;
+    };
+
+    // Debug info used to name uninitialized locals in runtime errors
+    struct LocalName {
+        uint16_t slot_;
+        size_t start_;
+        size_t end_;
+        tokens::Symbol name_;
+    };
+
+ private:
+    std::vector<uint8_t> code_;
+    std::vector<Value> constants_;
+    std::vector<LineStart> lines_;
+    std::vector<LocalName> local_names_;
+};
+
+}  // namespace lox::vm
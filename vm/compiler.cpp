@@ -0,0 +1,242 @@
+#include "compiler.hpp"
+
+#include <algorithm>
+#include <lox/lox.hpp>
+
+namespace lox::vm {
+
+Compiler::Compiler(Globals& globals, Lox& lox) : globals_(globals), lox_(lox) {
+}
+
+std::optional<Chunk> Compiler::Compile(const std::vector<statements::Stmt>& statements) {
+    for (const auto& statement : statements) {
+        Compile(statement);
+    }
+    Emit(OpCode::kReturn);
+    if (had_error_) {
+        return std::nullopt;
+    }
+    return std::move(chunk_);
+}
+
+void Compiler::Compile(const statements::Stmt& stmt) {
+    stmt.Accept(*this);
+}
+
+void Compiler::Compile(const expressions::Expr& expr) {
+    expr.Accept(*this);
+}
+
+void Compiler::CompileVar(const statements::Var& stmt) {
+    if (stmt.initializer_ != nullptr) {
+        Compile(*stmt.initializer_);
+    } else {
+        Emit(OpCode::kUninitialized);
+    }
+
+    line_ = stmt.name_.GetLine();
+    auto name = stmt.name_.GetSymbol();
+    if (scope_depth_ == 0) {
+        EmitGlobal(OpCode::kDefineGlobal, name);
+    } else if (auto slot = ResolveLocalInCurrentScope(name); slot.has_value()) {
+        // Redeclaration in the same block reuses the slot
+        Emit(OpCode::kSetLocal, *slot, kSlotWidth);
+        Emit(OpCode::kPop);
+    } else if (locals_.size() == kMaxSlots) {
+        Error("Too many local variables.");
+    } else {
+        // The initializer's value stays on the stack and becomes the local's slot
+        locals_.push_back({name, scope_depth_, chunk_.GetCode().size()});
+    }
+}
+
+void Compiler::CompileIf(const statements::If& stmt) {
+    Compile(*stmt.condition_);
+    auto else_jump = EmitJump(OpCode::kPopJumpIfFalse);
+    Compile(*stmt.then_branch_);
+    if (stmt.else_branch_ != nullptr) {
+        auto end_jump = EmitJump(OpCode::kJump);
+        PatchJump(else_jump);
+        Compile(*stmt.else_branch_);
+        PatchJump(end_jump);
+    } else {
+        PatchJump(else_jump);
+    }
+}
+
+void Compiler::CompileWhile(const statements::While& stmt) {
+    auto loop_start = chunk_.GetCode().size();
+    Compile(*stmt.condition_);
+    auto exit_jump = EmitJump(OpCode::kPopJumpIfFalse);
+    Compile(*stmt.statement_);
+    EmitLoop(loop_start);
+    PatchJump(exit_jump);
+}
+
+void Compiler::CompileUnary(const expressions::Unary& expr) {
+    Compile(*expr.expr_);
+    line_ = expr.op_.GetLine();
+    if (expr.op_.GetType() == tokens::Type::kMinus) {
+        Emit(OpCode::kNegate);
+    } else if (expr.op_.GetType() == tokens::Type::kBang) {
+        Emit(OpCode::kNot);
+    }
+}
+
+void Compiler::CompileBinary(const expressions::Binary& expr) {
+    Compile(*expr.left_);
+    if (expr.op_.GetType() == tokens::Type::kComma) {
+        Emit(OpCode::kPop);
+        Compile(*expr.right_);
+        return;
+    }
+    Compile(*expr.right_);
+
+    line_ = expr.op_.GetLine();
+    switch (expr.op_.GetType()) {
+        case tokens::Type::kPlus:
+            return Emit(OpCode::kAdd);
+        case tokens::Type::kMinus:
+            return Emit(OpCode::kSubtract);
+        case tokens::Type::kStar:
+            return Emit(OpCode::kMultiply);
+        case tokens::Type::kSlash:
+            return Emit(OpCode::kDivide);
+        case tokens::Type::kGreater:
+            return Emit(OpCode::kGreater);
+        case tokens::Type::kGreaterEqual:
+            return Emit(OpCode::kGreaterEqual);
+        case tokens::Type::kLess:
+            return Emit(OpCode::kLess);
+        case tokens::Type::kLessEqual:
+            return Emit(OpCode::kLessEqual);
+        case tokens::Type::kEqualEqual:
+            return Emit(OpCode::kEqual);
+        case tokens::Type::kBangEqual:
+            return Emit(OpCode::kNotEqual);
+        default:
+            throw std::runtime_error("Unknown operation.");
+    }
+}
+
+void Compiler::CompileConditional(const expressions::Conditional& expr) {
+    Compile(*expr.first_);
+    auto else_jump = EmitJump(OpCode::kPopJumpIfFalse);
+    Compile(*expr.second_);
+    auto end_jump = EmitJump(OpCode::kJump);
+    PatchJump(else_jump);
+    Compile(*expr.third_);
+    PatchJump(end_jump);
+}
+
+void Compiler::CompileLogical(const expressions::Logical& expr) {
+    Compile(*expr.left_);
+    auto end_jump = EmitJump(expr.op_.GetType() == tokens::Type::kOr ? OpCode::kJumpIfTrue : OpCode::kJumpIfFalse);
+    Emit(OpCode::kPop);
+    Compile(*expr.right_);
+    PatchJump(end_jump);
+}
+
+void Compiler::CompileVariable(const tokens::Token& name, OpCode local_op, OpCode global_op) {
+    line_ = name.GetLine();
+    if (auto slot = ResolveLocal(name.GetSymbol()); slot.has_value()) {
+        Emit(local_op, *slot, kSlotWidth);
+    } else {
+        EmitGlobal(global_op, name.GetSymbol());
+    }
+}
+
+void Compiler::BeginScope() {
+    ++scope_depth_;
+}
+
+void Compiler::EndScope() {
+    --scope_depth_;
+    uint32_t count = 0;
+    auto end = chunk_.GetCode().size();
+    while (!locals_.empty() && locals_.back().depth_ > scope_depth_) {
+        auto& local = locals_.back();
+        chunk_.AddLocalName(locals_.size() - 1, local.start_, end, local.name_);
+        locals_.pop_back();
+        ++count;
+    }
+
+    // A full scope of kMaxSlots locals doesn't fit in one operand
+    while (count > 1) {
+        auto popped = std::min(count, kMaxSlots - 1);
+        Emit(OpCode::kPopN, popped, kSlotWidth);
+        count -= popped;
+    }
+    if (count == 1) {
+        Emit(OpCode::kPop);
+    }
+}
+
+std::optional<uint16_t> Compiler::ResolveLocal(tokens::Symbol name) const {
+    for (auto i = locals_.size(); i > 0; --i) {
+        if (locals_[i - 1].name_ == name) {
+            return i - 1;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<uint16_t> Compiler::ResolveLocalInCurrentScope(tokens::Symbol name) const {
+    for (auto i = locals_.size(); i > 0 && locals_[i - 1].depth_ == scope_depth_; --i) {
+        if (locals_[i - 1].name_ == name) {
+            return i - 1;
+        }
+    }
+    return std::nullopt;
+}
+
+void Compiler::Emit(OpCode op) {
+    chunk_.Write(op, line_);
+}
+
+void Compiler::Emit(OpCode op, uint32_t operand, size_t width) {
+    chunk_.Write(op, line_);
+    chunk_.WriteOperand(operand, width, line_);
+}
+
+void Compiler::EmitConstant(Value value) {
+    if (chunk_.GetConstantsCount() == kMaxIndices) {
+        Error("Too many constants in one chunk.");
+        return;
+    }
+    Emit(OpCode::kConstant, chunk_.AddConstant(std::move(value)), kIndexWidth);
+}
+
+void Compiler::EmitGlobal(OpCode op, tokens::Symbol name) {
+    auto index = globals_.Resolve(name);
+    if (index >= kMaxIndices) {
+        Error("Too many global variables.");
+        return;
+    }
+    Emit(op, index, kIndexWidth);
+}
+
+void Compiler::EmitLoop(size_t loop_start) {
+    Emit(OpCode::kLoop);
+    // The offset is counted from the end of the operand
+    auto offset = chunk_.GetCode().size() + kJumpWidth - loop_start;
+    chunk_.WriteOperand(offset, kJumpWidth, line_);
+}
+
+size_t Compiler::EmitJump(OpCode op) {
+    Emit(op, 0, kJumpWidth);
+    return chunk_.GetCode().size() - kJumpWidth;
+}
+
+void Compiler::PatchJump(size_t operand_offset) {
+    // The offset is counted from the end of the operand
+    auto offset = chunk_.GetCode().size() - operand_offset - kJumpWidth;
+    chunk_.PatchOperand(operand_offset, offset, kJumpWidth);
+}
+
+void Compiler::Error(const std::string& message) {
+    lox_.Error(line_, message);
+    had_error_ = true;
+}
+
+}  // namespace lox::vm
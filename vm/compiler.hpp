@@ -0,0 +1,126 @@
+#pragma once
+
+#include <data_structures/ast/expressions.hpp>
+#include <data_structures/ast/statements.hpp>
+#include <optional>
+#include <vector>
+#include <vm/chunk.hpp>
+#include <vm/globals.hpp>
+
+namespace lox {
+
+class Lox;
+
+}  // namespace lox
+
+namespace lox::vm {
+
+// Translates the statements produced by Parser into a Chunk of bytecode.
+// Block-scoped variables live in stack slots resolved at compile time, the rest are globals.
+class Compiler {
+ public:
+    Compiler(Globals& globals, Lox& lox);
+    // Returns std::nullopt if a compile error was reported
+    std::optional<Chunk> Compile(const std::vector<statements::Stmt>& statements);
+
+    template <expressions::IsExpression Arg>
+    void operator()(const Arg& arg) {
+        if constexpr (std::is_same_v<Arg, expressions::Nil>) {
+            Emit(OpCode::kNil);
+        } else if constexpr (std::is_same_v<Arg, expressions::Boolean>) {
+            Emit(arg.value_ ? OpCode::kTrue : OpCode::kFalse);
+        } else if constexpr (std::is_same_v<Arg, expressions::String>) {
+            EmitConstant(*arg.constant_);
+        } else if constexpr (expressions::IsLiteral<Arg>) {
+            EmitConstant(Value(arg.value_));
+        } else if constexpr (std::is_same_v<Arg, expressions::Unary>) {
+            CompileUnary(arg);
+        } else if constexpr (std::is_same_v<Arg, expressions::Binary>) {
+            CompileBinary(arg);
+        } else if constexpr (std::is_same_v<Arg, expressions::Conditional>) {
+            CompileConditional(arg);
+        } else if constexpr (std::is_same_v<Arg, expressions::Grouping>) {
+            Compile(*arg.expr_);
+        } else if constexpr (std::is_same_v<Arg, expressions::Variable>) {
+            CompileVariable(arg.name_, OpCode::kGetLocal, OpCode::kGetGlobal);
+        } else if constexpr (std::is_same_v<Arg, expressions::Assign>) {
+            Compile(*arg.value_);
+            CompileVariable(arg.name_, OpCode::kSetLocal, OpCode::kSetGlobal);
+        } else if constexpr (std::is_same_v<Arg, expressions::Logical>) {
+            CompileLogical(arg);
+        } else {
+            throw std::runtime_error("Unexpected expression type.");
+        }
+    }
+
+    template <statements::IsStatement Arg>
+    void operator()(const Arg& arg) {
+        if constexpr (std::is_same_v<Arg, statements::Print>) {
+            Compile(*arg.expr_);
+            Emit(OpCode::kPrint);
+        } else if constexpr (std::is_same_v<Arg, statements::Expression>) {
+            Compile(*arg.expr_);
+            Emit(OpCode::kPop);
+        } else if constexpr (std::is_same_v<Arg, statements::Var>) {
+            CompileVar(arg);
+        } else if constexpr (std::is_same_v<Arg, statements::Block>) {
+            BeginScope();
+            for (const auto& statement : arg.statements_) {
+                Compile(statement);
+            }
+            EndScope();
+        } else if constexpr (std::is_same_v<Arg, statements::If>) {
+            CompileIf(arg);
+        } else if constexpr (std::is_same_v<Arg, statements::While>) {
+            CompileWhile(arg);
+        } else {
+            throw std::runtime_error("Unexpected statement type.");
+        }
+    }
+
+ private:
+    struct Local {
+        tokens::Symbol name_;
+        uint32_t depth_;
+        // Offset of the first instruction that can see the local
+        size_t start_;
+    };
+
+ private:
+    void Compile(const statements::Stmt& stmt);
+    void Compile(const expressions::Expr& expr);
+    void CompileVar(const statements::Var& stmt);
+    void CompileIf(const statements::If& stmt);
+    void CompileWhile(const statements::While& stmt);
+    void CompileUnary(const expressions::Unary& expr);
+    void CompileBinary(const expressions::Binary& expr);
+    void CompileConditional(const expressions::Conditional& expr);
+    void CompileLogical(const expressions::Logical& expr);
+    void CompileVariable(const tokens::Token& name, OpCode local_op, OpCode global_op);
+
+    void BeginScope();
+    void EndScope();
+    std::optional<uint16_t> ResolveLocal(tokens::Symbol name) const;
+    std::optional<uint16_t> ResolveLocalInCurrentScope(tokens::Symbol name) const;
+
+    void Emit(OpCode op);
+    void Emit(OpCode op, uint32_t operand, size_t width);
+    void EmitConstant(Value value);
+    // Operand of a global is the symbol of its name, so any symbol may be out of range
+    void EmitGlobal(OpCode op, tokens::Symbol name);
+    void EmitLoop(size_t loop_start);
+    size_t EmitJump(OpCode op);
+    void PatchJump(size_t operand_offset);
+    void Error(const std::string& message);
+
+ private:
+    Chunk chunk_;
+    std::vector<Local> locals_;
+    uint32_t scope_depth_ = 0;
+    uint32_t line_ = 1;
+    bool had_error_ = false;
+    Globals& globals_;
+    Lox& lox_;
+};
+
+}  // namespace lox::vm
@@ -0,0 +1,20 @@
+#include "globals.hpp"
+
+namespace lox::vm {
+
+Globals::Globals(const tokens::SymbolTable& symbols) : symbols_(symbols) {
+}
+
+uint32_t Globals::Resolve(tokens::Symbol name) {
+    auto index = static_cast<uint32_t>(name);
+    if (index >= values_.size()) {
+        values_.resize(symbols_.GetSize());
+    }
+    return index;
+}
+
+const std::string& Globals::GetName(uint32_t index) const {
+    return symbols_.GetName(static_cast<tokens::Symbol>(index));
+}
+
+}  // namespace lox::vm
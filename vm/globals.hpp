@@ -0,0 +1,29 @@
+#pragma once
+
+#include <data_structures/ast/value.hpp>
+#include <data_structures/tokens/symbols.hpp>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace lox::vm {
+
+// Global variables indexed by the symbol of their name.
+// Persists across REPL lines, so a name keeps its index for the whole session.
+class Globals {
+ public:
+    explicit Globals(const tokens::SymbolTable& symbols);
+    uint32_t Resolve(tokens::Symbol name);
+    const std::string& GetName(uint32_t index) const;
+
+    std::optional<Value>& operator[](uint32_t index) {
+        return values_[index];
+    }
+
+ private:
+    const tokens::SymbolTable& symbols_;
+    // std::nullopt marks a name that was referenced but not defined yet
+    std::vector<std::optional<Value>> values_;
+};
+
+}  // namespace lox::vm
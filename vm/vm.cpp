@@ -0,0 +1,242 @@
+#include "vm.hpp"
+
+#include <lox/errors.hpp>
+#include <lox/lox.hpp>
+#include <vm/compiler.hpp>
+
+namespace lox::vm {
+
+namespace {
+
+constexpr size_t kInitialStackSize = 256;
+
+}  // namespace
+
+VirtualMachine::VirtualMachine(Lox& lox) : globals_(lox.GetSymbols()), output_(lox.GetOutput()), lox_(lox) {
+    stack_.reserve(kInitialStackSize);
+}
+
+void VirtualMachine::Interpret(const std::vector<statements::Stmt>& statements) {
+    Compiler compiler(globals_, lox_);
+    auto chunk = compiler.Compile(statements);
+    if (!chunk.has_value()) {
+        return;
+    }
+
+    try {
+        Run(*chunk);
+    } catch (const RuntimeError& error) {
+        stack_.clear();
+        lox_.RuntimeError(error);
+    }
+}
+
+void VirtualMachine::Run(const Chunk& chunk) {
+    const uint8_t* code = chunk.GetCode().data();
+    const uint8_t* ip = code;
+    const uint8_t* instruction = ip;
+
+    auto read_operand = [&ip](size_t width) -> uint32_t {
+        auto operand = Chunk::ReadOperand(ip, width);
+        ip += width;
+        return operand;
+    };
+    auto line = [&]() -> uint32_t {
+        return chunk.GetLine(instruction - code);
+    };
+
+    while (true) {
+        instruction = ip;
+        switch (static_cast<OpCode>(*ip++)) {
+            case OpCode::kConstant:
+                stack_.push_back(chunk.GetConstant(read_operand(kIndexWidth)));
+                break;
+            case OpCode::kNil:
+                stack_.emplace_back(std::monostate{});
+                break;
+            case OpCode::kTrue:
+                stack_.emplace_back(true);
+                break;
+            case OpCode::kFalse:
+                stack_.emplace_back(false);
+                break;
+            case OpCode::kUninitialized:
+                stack_.emplace_back();
+                break;
+            case OpCode::kPop:
+                stack_.pop_back();
+                break;
+            case OpCode::kPopN:
+                stack_.resize(stack_.size() - read_operand(kSlotWidth));
+                break;
+            case OpCode::kGetLocal: {
+                auto slot = read_operand(kSlotWidth);
+                if (stack_[slot].Is<Uninitialized>()) {
+                    const auto& name = lox_.GetSymbols().GetName(chunk.GetLocalName(slot, instruction - code));
+                    throw RuntimeError(line(), "Access to uninitialized variable '" + name + "'.");
+                }
+                stack_.push_back(stack_[slot]);
+                break;
+            }
+            case OpCode::kSetLocal:
+                stack_[read_operand(kSlotWidth)] = stack_.back();
+                break;
+            case OpCode::kGetGlobal: {
+                auto index = read_operand(kIndexWidth);
+                const auto& value = globals_[index];
+                if (!value.has_value()) {
+                    throw RuntimeError(line(), "Undefined variable '" + globals_.GetName(index) + "'.");
+                } else if (value->Is<Uninitialized>()) {
+                    throw RuntimeError(line(), "Access to uninitialized variable '" + globals_.GetName(index) + "'.");
+                }
+                stack_.push_back(*value);
+                break;
+            }
+            case OpCode::kDefineGlobal:
+                globals_[read_operand(kIndexWidth)] = std::move(stack_.back());
+                stack_.pop_back();
+                break;
+            case OpCode::kSetGlobal: {
+                auto index = read_operand(kIndexWidth);
+                auto& value = globals_[index];
+                if (!value.has_value()) {
+                    throw RuntimeError(line(), "Undefined variable '" + globals_.GetName(index) + "'.");
+                }
+                *value = stack_.back();
+                break;
+            }
+            case OpCode::kEqual: {
+                bool equal = stack_[stack_.size() - 2] == stack_.back();
+                stack_.pop_back();
+                stack_.back() = Value(equal);
+                break;
+            }
+            case OpCode::kNotEqual: {
+                bool not_equal = stack_[stack_.size() - 2] != stack_.back();
+                stack_.pop_back();
+                stack_.back() = Value(not_equal);
+                break;
+            }
+            case OpCode::kGreater:
+                NumberOperation(line, [](double lhs, double rhs) {
+                    return lhs > rhs;
+                });
+                break;
+            case OpCode::kGreaterEqual:
+                NumberOperation(line, [](double lhs, double rhs) {
+                    return lhs >= rhs;
+                });
+                break;
+            case OpCode::kLess:
+                NumberOperation(line, [](double lhs, double rhs) {
+                    return lhs < rhs;
+                });
+                break;
+            case OpCode::kLessEqual:
+                NumberOperation(line, [](double lhs, double rhs) {
+                    return lhs <= rhs;
+                });
+                break;
+            case OpCode::kAdd: {
+                const auto& lhs = stack_[stack_.size() - 2];
+                const auto& rhs = stack_.back();
+                Value result;
+                if (lhs.Is<std::string>() && rhs.Is<std::string>()) {
+                    result = Value::Concatenate(lhs, rhs);
+                } else if (lhs.Is<double>() && rhs.Is<double>()) {
+                    result = Value(lhs.As<double>() + rhs.As<double>());
+                } else {
+                    throw RuntimeError(line(), "Operands must be two numbers or two strings.");
+                }
+                stack_.pop_back();
+                stack_.back() = std::move(result);
+                break;
+            }
+            case OpCode::kSubtract:
+                NumberOperation(line, [](double lhs, double rhs) {
+                    return lhs - rhs;
+                });
+                break;
+            case OpCode::kMultiply:
+                NumberOperation(line, [](double lhs, double rhs) {
+                    return lhs * rhs;
+                });
+                break;
+            case OpCode::kDivide:
+                if (stack_.back().Is<double>() && stack_.back().As<double>() == 0 &&
+                    stack_[stack_.size() - 2].Is<double>()) {
+                    throw RuntimeError(line(), "Division by zero.");
+                }
+                NumberOperation(line, [](double lhs, double rhs) {
+                    return lhs / rhs;
+                });
+                break;
+            case OpCode::kNot:
+                stack_.back() = Value(!IsTruthy(stack_.back()));
+                break;
+            case OpCode::kNegate:
+                if (!stack_.back().Is<double>()) {
+                    throw RuntimeError(line(), "Operand must be a number.");
+                }
+                stack_.back() = Value(-stack_.back().As<double>());
+                break;
+            case OpCode::kPrint:
+                stack_.back().Print(output_);
+                output_.EndLine();
+                stack_.pop_back();
+                break;
+            case OpCode::kJump:
+                ip += read_operand(kJumpWidth);
+                break;
+            case OpCode::kJumpIfFalse: {
+                auto offset = read_operand(kJumpWidth);
+                if (!IsTruthy(stack_.back())) {
+                    ip += offset;
+                }
+                break;
+            }
+            case OpCode::kJumpIfTrue: {
+                auto offset = read_operand(kJumpWidth);
+                if (IsTruthy(stack_.back())) {
+                    ip += offset;
+                }
+                break;
+            }
+            case OpCode::kPopJumpIfFalse: {
+                auto offset = read_operand(kJumpWidth);
+                if (!IsTruthy(stack_.back())) {
+                    ip += offset;
+                }
+                stack_.pop_back();
+                break;
+            }
+            case OpCode::kLoop:
+                ip -= read_operand(kJumpWidth);
+                break;
+            case OpCode::kReturn:
+                return;
+        }
+    }
+}
+
+template <typename Line, typename Operation>
+void VirtualMachine::NumberOperation(const Line& line, Operation&& operation) {
+    auto& lhs = stack_[stack_.size() - 2];
+    const auto& rhs = stack_.back();
+    if (!lhs.Is<double>() || !rhs.Is<double>()) {
+        throw RuntimeError(line(), "Operands must be numbers.");
+    }
+    lhs = Value(operation(lhs.As<double>(), rhs.As<double>()));
+    stack_.pop_back();
+}
+
+bool VirtualMachine::IsTruthy(const Value& value) {
+    if (value.Is<std::monostate>()) {
+        return false;
+    } else if (value.Is<bool>()) {
+        return value.As<bool>();
+    }
+    return true;
+}
+
+}  // namespace lox::vm
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <data_structures/ast/statements.hpp>
+#include <data_structures/ast/value.hpp>
+#include <lox/output_sink.hpp>
+#include <string>
+#include <vector>
+#include <vm/chunk.hpp>
+#include <vm/globals.hpp>
+
+namespace lox {
+
+class Lox;
+
+}  // namespace lox
+
+namespace lox::vm {
+
+// Stack-based bytecode interpreter, an alternative to AstInterpreter
+class VirtualMachine {
+ public:
+    explicit VirtualMachine(Lox& lox);
+    void Interpret(const std::vector<statements::Stmt>& statements);
+
+ private:
+    void Run(const Chunk& chunk);
+
+    // `line` is only called to report a runtime error
+    template <typename Line, typename Operation>
+    void NumberOperation(const Line& line, Operation&& operation);
+
+    static bool IsTruthy(const Value& value);
+
+ private:
+    Globals globals_;
+    std::vector<Value> stack_;
+    OutputSink& output_;
+    Lox& lox_;
+};
+
+}  // namespace lox::vm